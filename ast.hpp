@@ -25,8 +25,10 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "parser.hpp"
 #include "utils/strings.hpp"
 
 namespace ast {
@@ -35,11 +37,8 @@ namespace ast {
 	using std::vector;
 	using std::shared_ptr;
 
-	template<typename T, typename... Args>
-	shared_ptr<T> make_ptr(Args... args) { return std::make_shared<T>(args...); }
-
 	template<typename T, typename U>
-	shared_ptr<T> as_ptr(const shared_ptr<U>& r) { return std::static_pointer_cast<T>(r); }
+	T* as_ptr(U* r) { return static_cast<T*>(r); }
 
 	/** Represents a character range. */
 	class char_range {
@@ -56,7 +55,7 @@ namespace ast {
 					 *   as the first character, represents a single character 
 					 */
 	}; /* class char_range */
-	typedef shared_ptr<char_range> char_range_ptr;
+	typedef char_range* char_range_ptr;
 
 	class char_matcher;
 	class str_matcher;
@@ -75,6 +74,7 @@ namespace ast {
 	class capt_matcher;
 	class named_matcher;
 	class fail_matcher;
+	class cut_matcher;
 
 	/** Type of AST node. */
 	enum matcher_type {
@@ -94,7 +94,8 @@ namespace ast {
 		not_type,
 		capt_type,
 		named_type,
-		fail_type
+		fail_type,
+		cut_type
 	}; /* enum matcher_type */
 	
 	/** Abstract base class of all matcher visitors.
@@ -118,6 +119,7 @@ namespace ast {
 		virtual void visit(capt_matcher&) = 0;
 		virtual void visit(named_matcher&) = 0;
 		virtual void visit(fail_matcher&) = 0;
+		virtual void visit(cut_matcher&) = 0;
 	}; /* class visitor */
 	
 	/** Abstract base class of all matchers.
@@ -129,7 +131,7 @@ namespace ast {
 		/** Gets type tag. */
 		virtual matcher_type type() = 0;
 	}; /* class matcher */
-	typedef shared_ptr<matcher> matcher_ptr;
+	typedef matcher* matcher_ptr;
 	
 	/** Matches a character literal. */
 	class char_matcher : public matcher {
@@ -142,12 +144,12 @@ namespace ast {
 		
 		char c; /**< char to match */
 	}; /* class char_matcher */
-	typedef shared_ptr<char_matcher> char_matcher_ptr;
+	typedef char_matcher* char_matcher_ptr;
 
 	/** Matches a string literal. */
 	class str_matcher : public matcher {
 	public:
-		str_matcher(string s) : s(s) {}
+		str_matcher(string s) : s(std::move(s)) {}
 		str_matcher() : s("") {}
 
 		void accept(visitor* v) { v->visit(*this); }
@@ -155,13 +157,13 @@ namespace ast {
 
 		string s; /**< string to match */
 	}; /* class str_matcher */
-	typedef shared_ptr<str_matcher> str_matcher_ptr;
+	typedef str_matcher* str_matcher_ptr;
 
 	/** Matches a character range. */
 	class range_matcher : public matcher {
 	public:
-		range_matcher(string var) : var(var) {}
-		range_matcher() : var("") {}
+		range_matcher(string var) : var(std::move(var)), neg(false) {}
+		range_matcher() : var(""), neg(false) {}
 
 		void accept(visitor* v) { v->visit(*this); }
 		matcher_type type() { return range_type; }
@@ -171,14 +173,16 @@ namespace ast {
 		vector<char_range> rs;  /**< contained character ranges */
 		string var;             /**< variable to bind to the captured character.
 		                         *   Empty if unset. */
+		bool neg;               /**< Matches characters not in the ranges instead 
+		                         *   (never end of input) [default false] */
 	}; /* class range_matcher */
-	typedef shared_ptr<range_matcher> range_matcher_ptr;
+	typedef range_matcher* range_matcher_ptr;
 
 	/** Matches a grammar rule invocation. */
 	class rule_matcher : public matcher {
 	public:
-		rule_matcher(string rule) : rule(rule), var("") {}
-		rule_matcher(string rule, string var) : rule(rule), var(var) {}
+		rule_matcher(string rule) : rule(std::move(rule)), var("") {}
+		rule_matcher(string rule, string var) : rule(std::move(rule)), var(std::move(var)) {}
 		rule_matcher() : rule(""), var("") {}
 
 		void accept(visitor* v) { v->visit(*this); }
@@ -188,12 +192,12 @@ namespace ast {
 		string var;		/**< Variable to bind to the rule return. 
 						 *   Empty if unset. */
 	}; /* class rule_matcher */
-	typedef shared_ptr<rule_matcher> rule_matcher_ptr;
+	typedef rule_matcher* rule_matcher_ptr;
 
 	/** Matches any character. */
 	class any_matcher : public matcher {
 	public:
-		any_matcher(string var) : var(var) {}
+		any_matcher(string var) : var(std::move(var)) {}
 		any_matcher() : var("") {}
 
 		void accept(visitor* v) { v->visit(*this); }
@@ -202,7 +206,7 @@ namespace ast {
 		string var;  /**< variable to bind to the captured character.
 		              *   Empty if unset. */
 	}; /* class any_matcher */
-	typedef shared_ptr<any_matcher> any_matcher_ptr;
+	typedef any_matcher* any_matcher_ptr;
 
 	/** Always matches without consuming a character. */
 	class empty_matcher : public matcher {
@@ -212,12 +216,12 @@ namespace ast {
 		void accept(visitor* v) { v->visit(*this); }
 		matcher_type type() { return empty_type; }
 	}; /* class empty_matcher */
-	typedef shared_ptr<empty_matcher> empty_matcher_ptr;
+	typedef empty_matcher* empty_matcher_ptr;
 
 	/** Semantic action; not actually a matcher. */
 	class action_matcher : public matcher {
 	public:
-		action_matcher(string a) : a(a) {}
+		action_matcher(string a) : a(std::move(a)) {}
 		action_matcher() : a("") {}
 
 		void accept(visitor* v) { v->visit(*this); }
@@ -225,46 +229,46 @@ namespace ast {
 
 		string a; /**< The string representing the action */
 	}; /* class action_matcher */
-	typedef shared_ptr<action_matcher> action_matcher_ptr;
+	typedef action_matcher* action_matcher_ptr;
 
 	/** An optional matcher */
 	class opt_matcher : public matcher {
 	public:
-		opt_matcher(shared_ptr<matcher> m) : m(m) {}
-		opt_matcher() {}
+		opt_matcher(matcher* m) : m(m) {}
+		opt_matcher() : m(nullptr) {}
 
 		void accept(visitor* v) { v->visit(*this); }
 		matcher_type type() { return opt_type; }
 
-		shared_ptr<matcher> m; /**< contained matcher */
+		matcher* m; /**< contained matcher */
 	}; /* class opt_matcher */
-	typedef shared_ptr<opt_matcher> opt_matcher_ptr;
+	typedef opt_matcher* opt_matcher_ptr;
 
 	/** Matches any number of times */
 	class many_matcher : public matcher {
 	public:
-		many_matcher(shared_ptr<matcher> m) : m(m) {}
-		many_matcher() {}
+		many_matcher(matcher* m) : m(m) {}
+		many_matcher() : m(nullptr) {}
 
 		void accept(visitor* v) { v->visit(*this); }
 		matcher_type type() { return many_type; }
 
-		shared_ptr<matcher> m; /**< contained matcher */
+		matcher* m; /**< contained matcher */
 	}; /* class many_matcher */
-	typedef shared_ptr<many_matcher> many_matcher_ptr;
+	typedef many_matcher* many_matcher_ptr;
 
 	/** Matches some non-zero number of times */
 	class some_matcher : public matcher {
 	public:
-		some_matcher(shared_ptr<matcher> m) : m(m) {}
-		some_matcher() {}
+		some_matcher(matcher* m) : m(m) {}
+		some_matcher() : m(nullptr) {}
 
 		void accept(visitor* v) { v->visit(*this); }
 		matcher_type type() { return some_type; }
 
-		shared_ptr<matcher> m; /**< contained matcher */
+		matcher* m; /**< contained matcher */
 	}; /* class some_matcher */
-	typedef shared_ptr<some_matcher> some_matcher_ptr;
+	typedef some_matcher* some_matcher_ptr;
 
 	/** Sequence of matchers. */
 	class seq_matcher : public matcher {
@@ -274,11 +278,11 @@ namespace ast {
 		void accept(visitor* v) { v->visit(*this); }
 		matcher_type type() { return seq_type; }
 
-		seq_matcher& operator += (shared_ptr<matcher> m) { ms.push_back(m); return *this; }
+		seq_matcher& operator += (matcher* m) { ms.push_back(m); return *this; }
 
-		vector<shared_ptr<matcher>> ms; /**< The matchers in the sequence */
+		vector<matcher*> ms; /**< The matchers in the sequence */
 	}; /* class seq_matcher */
-	typedef shared_ptr<seq_matcher> seq_matcher_ptr;
+	typedef seq_matcher* seq_matcher_ptr;
 
 	/** Alternation matcher. */
 	class alt_matcher : public matcher {
@@ -288,71 +292,71 @@ namespace ast {
 		void accept(visitor* v) { v->visit(*this); }
 		matcher_type type() { return alt_type; }
 
-		alt_matcher& operator += (shared_ptr<matcher> m) { ms.push_back(m); return *this; }
+		alt_matcher& operator += (matcher* m) { ms.push_back(m); return *this; }
 
-		vector<shared_ptr<matcher>> ms; /**< The alternate matchers */
+		vector<matcher*> ms; /**< The alternate matchers */
 	}; /* class alt_matcher */
-	typedef shared_ptr<alt_matcher> alt_matcher_ptr;
+	typedef alt_matcher* alt_matcher_ptr;
 
 	/** Lookahead matcher. */
 	class look_matcher : public matcher {
 	public:
-		look_matcher(shared_ptr<matcher> m) : m(m) {}
-		look_matcher() {}
+		look_matcher(matcher* m) : m(m) {}
+		look_matcher() : m(nullptr) {}
 
 		void accept(visitor* v) { v->visit(*this); }
 		matcher_type type() { return look_type; }
 
-		shared_ptr<matcher> m; /**< The matcher to check on lookahead */
+		matcher* m; /**< The matcher to check on lookahead */
 	}; /* class look_matcher */
-	typedef shared_ptr<look_matcher> look_matcher_ptr;
+	typedef look_matcher* look_matcher_ptr;
 
 	/** Negative lookahead matcher. */
 	class not_matcher : public matcher {
 	public:
-		not_matcher(shared_ptr<matcher> m) : m(m) {}
-		not_matcher() {}
+		not_matcher(matcher* m) : m(m) {}
+		not_matcher() : m(nullptr) {}
 
 		void accept(visitor* v) { v->visit(*this); }
 		matcher_type type() { return not_type; }
 
-		shared_ptr<matcher> m; /**< The matcher to check on lookahead */
+		matcher* m; /**< The matcher to check on lookahead */
 	}; /* class not_matcher */
-	typedef shared_ptr<not_matcher> not_matcher_ptr;
+	typedef not_matcher* not_matcher_ptr;
 
 	/** String-capturing matcher. */
 	class capt_matcher : public matcher {
 	public:
-		capt_matcher(shared_ptr<matcher> m, string var) : m(m), var(var) {}
-		capt_matcher() {}
+		capt_matcher(matcher* m, string var) : m(m), var(std::move(var)) {}
+		capt_matcher() : m(nullptr) {}
 
 		void accept(visitor* v) { v->visit(*this); }
 		matcher_type type() { return capt_type; }
 
-		shared_ptr<matcher> m; /**< Captured matcher */
+		matcher* m; /**< Captured matcher */
 		string var;            /**< Variable to bind to the captured string.
 		                        *   Empty if unset. */
 	}; /* class capt_matcher */
-	typedef shared_ptr<capt_matcher> capt_matcher_ptr;
+	typedef capt_matcher* capt_matcher_ptr;
 	
 	/** Named-error matcher. */
 	class named_matcher : public matcher {
 	public:
-		named_matcher(shared_ptr<matcher> m, string error) : m(m), error(error) {}
-		named_matcher() {}
+		named_matcher(matcher* m, string error) : m(m), error(std::move(error)) {}
+		named_matcher() : m(nullptr) {}
 		
 		void accept(visitor* v) { v->visit(*this); }
 		matcher_type type() { return named_type; }
 		
-		shared_ptr<matcher> m;  /**< Matcher to name on failure */
+		matcher* m;  /**< Matcher to name on failure */
 		string error;           /**< Name of matcher in case of error */
 	}; /* class named_matcher */
-	typedef shared_ptr<named_matcher> named_matcher_ptr;
+	typedef named_matcher* named_matcher_ptr;
 	
 	/** Error matcher */
 	class fail_matcher : public matcher {
 	public:
-		fail_matcher(string error) : error(error) {}
+		fail_matcher(string error) : error(std::move(error)) {}
 		fail_matcher() {}
 		
 		void accept(visitor* v) { v->visit(*this); }
@@ -360,7 +364,18 @@ namespace ast {
 		
 		string error;  /**< Error string to emit */
 	}; /* class fail_matcher */
-	typedef shared_ptr<fail_matcher> fail_matcher_ptr;
+	typedef fail_matcher* fail_matcher_ptr;
+	
+	/** Cut matcher; always matches without consuming a character, and 
+	 *  discards all parser state before the current position. */
+	class cut_matcher : public matcher {
+	public:
+		cut_matcher() {}
+		
+		void accept(visitor* v) { v->visit(*this); }
+		matcher_type type() { return cut_type; }
+	}; /* class cut_matcher */
+	typedef cut_matcher* cut_matcher_ptr;
 
 	/** Empty visitor class; provides a default implementation of each of the 
 	 *  methods. */
@@ -383,6 +398,7 @@ namespace ast {
 		virtual void visit(capt_matcher& m) {}
 		virtual void visit(named_matcher& m) {}
 		virtual void visit(fail_matcher& m) {}
+		virtual void visit(cut_matcher& m) {}
 	}; /* class default_visitor */
 	
 	/** Default visitor which visits the entire tree. */
@@ -407,42 +423,58 @@ namespace ast {
 	};
 
 	/** Represents a grammar rule.
-	 *  Pairs a name and optional type with a matching rule. The contained rule 
-	 *  will be deleted on destruction. */
+	 *  Pairs a name and optional type with a matching rule. The rule and its matchers 
+	 *  are owned by the arena of their grammar. */
 	class grammar_rule {
 	public:
-		grammar_rule(string name) : name(name), memo(true) {}
-		grammar_rule(string name, shared_ptr<matcher> m) : name(name), memo(true), m(m) {}
-		grammar_rule(string name, string type, shared_ptr<matcher> m)
-			: name(name), type(type), memo(true), m(m) {}
-		grammar_rule(string name, string type, string error, shared_ptr<matcher> m) 
-			: name(name), type(type), error(error), memo(true), m(m) {}
-		grammar_rule(string name, string type, string error, bool memo, shared_ptr<matcher> m) 
-			: name(name), type(type), error(error), memo(memo), m(m) {}
-		grammar_rule() {}
+		grammar_rule(string name) 
+			: name(std::move(name)), memo(true), once(false), m(nullptr) {}
+		grammar_rule(string name, matcher* m) 
+			: name(std::move(name)), memo(true), once(false), m(m) {}
+		grammar_rule(string name, string type, matcher* m)
+			: name(std::move(name)), type(std::move(type)), memo(true), once(false), m(m) {}
+		grammar_rule(string name, string type, string error, matcher* m) 
+			: name(std::move(name)), type(std::move(type)), error(std::move(error)), 
+			  memo(true), once(false), m(m) {}
+		grammar_rule(string name, string type, string error, bool memo, matcher* m) 
+			: name(std::move(name)), type(std::move(type)), error(std::move(error)), 
+			  memo(memo), once(false), m(m) {}
+		grammar_rule() : memo(true), once(false), m(nullptr) {}
 		
 		string name;            /**< Name of the grammar rule */
 		string type;            /**< Type of the grammar rule's return (empty for none) */
 		string error;           /**< "Expected" error if the rule doesn't match */
 		bool memo;              /**< Should this rule be memoized [default true] */
-		shared_ptr<matcher> m;  /**< Grammar matching rule */
+		bool once;              /**< Are this rule's memoized results reused at most once, 
+		                         *   so may be moved out of the table? [default false] */
+		matcher* m;             /**< Grammar matching rule */
 	}; /* class grammar_rule */
-	typedef shared_ptr<grammar_rule> grammar_rule_ptr;
+	typedef grammar_rule* grammar_rule_ptr;
 
 	/** Represents a Egg grammar. 
-	 *  Deletes the contained grammar rules on destruction. */
+	 *  Its rules and their matchers are allocated in the grammar's arena, and refer to 
+	 *  each other by plain pointers; they are all destroyed with the grammar. */
 	class grammar {
 	public:
 		grammar() {}
+		
+		/** Takes ownership of the values of an arena, such as the arena of the parser 
+		 *  state which built the grammar's rules */
+		grammar(parser::arena&& nodes) : nodes(std::move(nodes)) {}
+		
+		/** Constructs a node of the grammar's syntax tree, owned by the grammar */
+		template<typename T, typename... Args>
+		T* make(Args&&... args) { return nodes.make<T>(std::forward<Args>(args)...); }
 
-		grammar& operator += (shared_ptr<grammar_rule> r) {
+		grammar& operator += (grammar_rule* r) {
 			rs.push_back(r);
 			names.insert(std::make_pair(r->name, r));
 			return *this;
 		}
 
-		vector<shared_ptr<grammar_rule>> rs;	/**< list of grammar rules */
-		unordered_map<string, shared_ptr<grammar_rule>> names;
+		parser::arena nodes;			/**< owns the rules and matchers */
+		vector<grammar_rule*> rs;	/**< list of grammar rules */
+		unordered_map<string, grammar_rule*> names;
 										/**< lookup table of grammar rules by name */
 		string pre, post;				/**< pre and post-actions */
 	}; /* class grammar */
@@ -74,37 +74,47 @@ namespace egg {
 	bool END(parser::state&);
 	bool EXPECT(parser::state&);
 	bool FAIL(parser::state&);
+	bool CUT(parser::state&);
 	bool _(parser::state&);
 	bool space(parser::state&);
 	bool comment(parser::state&);
 	bool end_of_line(parser::state&);
 	bool end_of_file(parser::state&);
 
-	bool grammar(parser::state& ps, ast::grammar_ptr & psVal) {
-		ast::grammar_rule_ptr  r;
-		std::string  s;
+	bool grammar(parser::state& ps, ast::grammar_ptr & psOut) {
+		static thread_local ast::grammar_ptr  psVal;
+		static thread_local ast::grammar_rule_ptr  r;
+		static thread_local std::string  s;
 
-		return parser::named("grammar", 
+		static thread_local const parser::combinator psRule = parser::named("grammar", 
 			parser::sequence({
-				[&](parser::state& ps) { psVal = ast::make_ptr<ast::grammar>();  return true; },
+				[](parser::state& ps) { psVal = std::make_shared<ast::grammar>();  return true; },
 				_,
 				parser::option(
 					parser::sequence({
 						parser::bind(s, out_action),
-						[&](parser::state& ps) { psVal->pre = s;  return true; }})),
+						[](parser::state& ps) { psVal->pre = std::move(s);  return true; }})),
 				parser::some(
 					parser::sequence({
 						parser::bind(r, rule),
-						[&](parser::state& ps) { *psVal += r;  return true; }})),
+						[](parser::state& ps) { *psVal += r;  return true; }})),
 				parser::option(
 					parser::sequence({
 						parser::bind(s, out_action),
-						[&](parser::state& ps) { psVal->post = s;  return true; }})),
-				end_of_file}))(ps);
+						[](parser::state& ps) { psVal->post = std::move(s);  return true; }})),
+				end_of_file,
+				[](parser::state& ps) { psVal->nodes = std::move(ps.arena());  return true; }}));
+
+		parser::frame_slot<ast::grammar_ptr > psFrame_psVal(psVal, psOut);
+		parser::frame_slot<ast::grammar_rule_ptr > psFrame_r(r);
+		parser::frame_slot<std::string > psFrame_s(s);
+		return psRule(ps);
 	}
 
-	bool out_action(parser::state& ps, std::string & psVal) {
-		return parser::named("out action", 
+	bool out_action(parser::state& ps, std::string & psOut) {
+		static thread_local std::string  psVal;
+
+		static thread_local const parser::combinator psRule = parser::named("out action", 
 			parser::sequence({
 				OUT_BEGIN,
 				parser::capture(psVal, parser::memoize_many(1, 
@@ -112,68 +122,87 @@ namespace egg {
 						parser::look_not(OUT_END),
 						parser::any()}))),
 				OUT_END,
-				_}))(ps);
+				_}));
+
+		parser::frame_slot<std::string > psFrame_psVal(psVal, psOut);
+		return psRule(ps);
 	}
 
-	bool rule(parser::state& ps, ast::grammar_rule_ptr & psVal) {
-		ast::alt_matcher_ptr  m;
+	bool rule(parser::state& ps, ast::grammar_rule_ptr & psOut) {
+		static thread_local ast::grammar_rule_ptr  psVal;
+		static thread_local ast::alt_matcher_ptr  m;
 
-		return parser::named("rule", 
+		static thread_local const parser::combinator psRule = parser::named("rule", 
 			parser::sequence({
 				parser::bind(psVal, rule_lhs),
 				parser::bind(m, choice),
-				[&](parser::state& ps) { psVal->m = m;  return true; }}))(ps);
+				[](parser::state& ps) { psVal->m = m;  return true; }}));
+
+		parser::frame_slot<ast::grammar_rule_ptr > psFrame_psVal(psVal, psOut);
+		parser::frame_slot<ast::alt_matcher_ptr > psFrame_m(m);
+		return psRule(ps);
 	}
 
-	bool rule_lhs(parser::state& ps, ast::grammar_rule_ptr & psVal) {
-		std::string  s;
-		std::string  t;
+	bool rule_lhs(parser::state& ps, ast::grammar_rule_ptr & psOut) {
+		static thread_local ast::grammar_rule_ptr  psVal;
+		static thread_local std::string  s;
+		static thread_local std::string  t;
 
-		return parser::memoize(2, psVal, 
+		static thread_local const parser::combinator psRule = parser::memoize(2, psVal, 
 			parser::sequence({
 				parser::bind(s, identifier),
-				[&](parser::state& ps) { psVal = ast::make_ptr<ast::grammar_rule>(s);  return true; },
+				[](parser::state& ps) { psVal = ps.arena().make<ast::grammar_rule>(s);  return true; },
 				parser::option(
 					parser::sequence({
 						BIND,
 						parser::bind(t, type_id),
-						[&](parser::state& ps) { psVal->type = t;  return true; }})),
+						[](parser::state& ps) { psVal->type = std::move(t);  return true; }})),
 				parser::option(
 					parser::sequence({
 						parser::bind(t, err_string),
-						[&](parser::state& ps) { psVal->error = t.empty() ? s : t;  return true; }})),
+						[](parser::state& ps) { psVal->error = t.empty() ? s : t;  return true; }})),
 				parser::option(
-					parser::sequence({
-						parser::named("\"%no-memo\"", parser::literal("%no-memo")),
-						_,
-						[&](parser::state& ps) { psVal->memo = false;  return true; }})),
-				EQUAL}))(ps);
+					parser::choice({
+						parser::guard(parser::charset{{0x00000000u, 0x00000020u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, 
+							parser::sequence({
+								parser::named("\"%no-memo\"", parser::literal("%no-memo")),
+								_,
+								[](parser::state& ps) { psVal->memo = false;  return true; }}), "\"%no-memo\""),
+						parser::guard(parser::charset{{0x00000000u, 0x00000020u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, 
+							parser::sequence({
+								parser::named("\"%memo-once\"", parser::literal("%memo-once")),
+								_,
+								[](parser::state& ps) { psVal->once = true;  return true; }}), "\"%memo-once\"")})),
+				EQUAL}));
+
+		parser::frame_slot<ast::grammar_rule_ptr > psFrame_psVal(psVal, psOut);
+		parser::frame_slot<std::string > psFrame_s(s);
+		parser::frame_slot<std::string > psFrame_t(t);
+		return psRule(ps);
 	}
 
-	bool identifier(parser::state& ps, std::string & psVal) {
-		return parser::memoize(3, psVal, parser::named("identifier", 
+	bool identifier(parser::state& ps, std::string & psOut) {
+		static thread_local std::string  psVal;
+
+		static thread_local const parser::combinator psRule = parser::memoize_once(3, psVal, parser::named("identifier", 
 			parser::sequence({
 				parser::capture(psVal, 
 					parser::sequence({
-						
-							parser::choice({
-								parser::between('A', 'Z'),
-								parser::between('a', 'z'),
-								parser::literal('_')}),
-						parser::memoize_many(4, 
-							parser::choice({
-								parser::between('A', 'Z'),
-								parser::between('a', 'z'),
-								parser::literal('_'),
-								parser::between('0', '9')}))})),
-				_})))(ps);
+						parser::in_set(parser::charset{{0x00000000u, 0x00000000u, 0x87fffffeu, 0x07fffffeu, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}),
+						parser::many_in(parser::scan_set{parser::charset{{0x00000000u, 0x03ff0000u, 0x87fffffeu, 0x07fffffeu, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, {0xa8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf0, 0x50, 0x50, 0x50, 0x50, 0x70}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}}, 0, parser::in_set(parser::charset{{0x00000000u, 0x03ff0000u, 0x87fffffeu, 0x07fffffeu, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}))})),
+				_})));
+
+		parser::frame_slot<std::string > psFrame_psVal(psVal, psOut);
+		return psRule(ps);
 	}
 
-	bool type_id(parser::state& ps, std::string & psVal) {
-		return parser::memoize(5, psVal, parser::named("type ID", parser::capture(psVal, 
+	bool type_id(parser::state& ps, std::string & psOut) {
+		static thread_local std::string  psVal;
+
+		static thread_local const parser::combinator psRule = parser::memoize(4, psVal, parser::named("type ID", parser::capture(psVal, 
 			parser::sequence({
 				parser::unbind(identifier),
-				parser::memoize_many(6, 
+				parser::memoize_many(5, 
 					parser::sequence({
 						parser::literal("::"),
 						_,
@@ -183,205 +212,253 @@ namespace egg {
 						parser::literal('<'),
 						_,
 						parser::unbind(type_id),
-						parser::memoize_many(7, 
+						parser::memoize_many(6, 
 							parser::sequence({
 								parser::literal(','),
 								_,
 								parser::unbind(type_id)})),
 						parser::literal('>'),
-						_}))}))))(ps);
+						_}))}))));
+
+		parser::frame_slot<std::string > psFrame_psVal(psVal, psOut);
+		return psRule(ps);
 	}
 
-	bool err_string(parser::state& ps, std::string & psVal) {
-		std::string s;
+	bool err_string(parser::state& ps, std::string & psOut) {
+		static thread_local std::string  psVal;
+		static thread_local std::string s;
 
-		return parser::memoize(8, psVal, parser::named("error string", 
+		static thread_local const parser::combinator psRule = parser::memoize(7, psVal, parser::named("error string", 
 			parser::sequence({
 				parser::literal('`'),
-				parser::capture(s, parser::memoize_many(9, 
+				parser::capture(s, parser::memoize_many(8, 
 					parser::choice({
-						parser::literal("\\\\"),
-						parser::literal("\\`"),
+						[](parser::state& ps) -> bool {
+							switch ( ps() ) {
+							case '\\':
+								switch ( ps.peek(1) ) {
+								case '\\':
+									ps += 2; return true;
+								case '`':
+									ps.fail(); ps += 2; return true;
+								default:
+									ps.fail(); return false;
+								}
+							default:
+								ps.fail(); return false;
+							}
+						},
 						
 							parser::sequence({
-								parser::look_not(
-									parser::choice({
-										parser::literal('`'),
-										parser::literal('\t'),
-										parser::literal('\n'),
-										parser::literal('\r')})),
+								parser::look_not(parser::in_set(parser::charset{{0x00002600u, 0x00000000u, 0x00000000u, 0x00000001u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}})),
 								parser::any()})}))),
 				parser::literal('`'),
 				_,
-				[&](parser::state& ps) { psVal = strings::unescape_error(s);  return true; }})))(ps);
+				[](parser::state& ps) { psVal = strings::unescape_error(s);  return true; }})));
+
+		parser::frame_slot<std::string > psFrame_psVal(psVal, psOut);
+		parser::frame_slot<std::string> psFrame_s(s);
+		return psRule(ps);
 	}
 
-	bool choice(parser::state& ps, ast::alt_matcher_ptr & psVal) {
-		ast::seq_matcher_ptr  m;
+	bool choice(parser::state& ps, ast::alt_matcher_ptr & psOut) {
+		static thread_local ast::alt_matcher_ptr  psVal;
+		static thread_local ast::seq_matcher_ptr  m;
 
-		return parser::memoize(10, psVal, 
+		static thread_local const parser::combinator psRule = parser::memoize(9, psVal, 
 			parser::sequence({
 				parser::bind(m, sequence),
-				[&](parser::state& ps) { psVal = ast::make_ptr<ast::alt_matcher>(); *psVal += m;  return true; },
+				[](parser::state& ps) { psVal = ps.arena().make<ast::alt_matcher>(); *psVal += m;  return true; },
 				parser::many(
 					parser::sequence({
 						PIPE,
 						parser::bind(m, sequence),
-						[&](parser::state& ps) { *psVal += m;  return true; }}))}))(ps);
+						[](parser::state& ps) { *psVal += m;  return true; }}))}));
+
+		parser::frame_slot<ast::alt_matcher_ptr > psFrame_psVal(psVal, psOut);
+		parser::frame_slot<ast::seq_matcher_ptr > psFrame_m(m);
+		return psRule(ps);
 	}
 
-	bool sequence(parser::state& ps, ast::seq_matcher_ptr & psVal) {
-		ast::action_matcher_ptr  a;
-		ast::matcher_ptr  e;
+	bool sequence(parser::state& ps, ast::seq_matcher_ptr & psOut) {
+		static thread_local ast::seq_matcher_ptr  psVal;
+		static thread_local ast::action_matcher_ptr  a;
+		static thread_local ast::matcher_ptr  e;
 
-		return parser::memoize(11, psVal, 
+		static thread_local const parser::combinator psRule = parser::memoize(10, psVal, 
 			parser::sequence({
-				[&](parser::state& ps) { psVal = ast::make_ptr<ast::seq_matcher>();  return true; },
+				[](parser::state& ps) { psVal = ps.arena().make<ast::seq_matcher>();  return true; },
 				parser::some(
 					parser::choice({
 						
 							parser::sequence({
 								parser::bind(e, expression),
-								[&](parser::state& ps) { *psVal += e;  return true; }}),
+								[](parser::state& ps) { *psVal += e;  return true; }}),
 						
 							parser::sequence({
 								parser::bind(a, action),
-								[&](parser::state& ps) { *psVal += a;  return true; }})}))}))(ps);
+								[](parser::state& ps) { *psVal += a;  return true; }})}))}));
+
+		parser::frame_slot<ast::seq_matcher_ptr > psFrame_psVal(psVal, psOut);
+		parser::frame_slot<ast::action_matcher_ptr > psFrame_a(a);
+		parser::frame_slot<ast::matcher_ptr > psFrame_e(e);
+		return psRule(ps);
 	}
 
-	bool expression(parser::state& ps, ast::matcher_ptr & psVal) {
-		ast::matcher_ptr  m;
-		std::string  s;
+	bool expression(parser::state& ps, ast::matcher_ptr & psOut) {
+		static thread_local ast::matcher_ptr  psVal;
+		static thread_local ast::matcher_ptr  m;
+		static thread_local std::string  s;
 
-		return parser::memoize(12, psVal, parser::named("expression", 
+		static thread_local const parser::combinator psRule = parser::memoize(11, psVal, parser::named("expression", 
 			parser::choice({
-				
+				parser::guard(parser::charset{{0x00000000u, 0x00000040u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, 
 					parser::sequence({
 						AND,
 						parser::bind(m, primary),
-						[&](parser::state& ps) { psVal = ast::make_ptr<ast::look_matcher>(m);  return true; }}),
-				
+						[](parser::state& ps) { psVal = ps.arena().make<ast::look_matcher>(m);  return true; }}), "\'&\'"),
+				parser::guard(parser::charset{{0x00000000u, 0x00000002u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, 
 					parser::sequence({
 						NOT,
 						parser::bind(m, primary),
-						[&](parser::state& ps) { psVal = ast::make_ptr<ast::not_matcher>(m);  return true; }}),
+						[](parser::state& ps) { psVal = ps.arena().make<ast::not_matcher>(m);  return true; }}), "\'!\'"),
 				
 					parser::sequence({
 						parser::bind(m, primary),
-						[&](parser::state& ps) { psVal = m;  return true; },
+						[](parser::state& ps) { psVal = m;  return true; },
 						parser::option(
 							parser::choice({
-								
+								parser::guard(parser::charset{{0x00000000u, 0x80000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, 
 									parser::sequence({
 										OPT,
-										[&](parser::state& ps) { psVal = ast::make_ptr<ast::opt_matcher>(m);  return true; }}),
-								
+										[](parser::state& ps) { psVal = ps.arena().make<ast::opt_matcher>(m);  return true; }}), "\'?\'"),
+								parser::guard(parser::charset{{0x00000000u, 0x00000400u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, 
 									parser::sequence({
 										STAR,
-										[&](parser::state& ps) { psVal = ast::make_ptr<ast::many_matcher>(m);  return true; }}),
-								
+										[](parser::state& ps) { psVal = ps.arena().make<ast::many_matcher>(m);  return true; }}), "\'*\'"),
+								parser::guard(parser::charset{{0x00000000u, 0x00000800u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, 
 									parser::sequence({
 										PLUS,
-										[&](parser::state& ps) { psVal = ast::make_ptr<ast::some_matcher>(m);  return true; }}),
-								
+										[](parser::state& ps) { psVal = ps.arena().make<ast::some_matcher>(m);  return true; }}), "\'+\'"),
+								parser::guard(parser::charset{{0x00000000u, 0x00000000u, 0x00000001u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, 
 									parser::sequence({
 										EXPECT,
 										parser::bind(s, err_string),
-										[&](parser::state& ps) { psVal = ast::make_ptr<ast::named_matcher>(m, s);  return true; }})}))})})))(ps);
+										[](parser::state& ps) { psVal = ps.arena().make<ast::named_matcher>(m, std::move(s));  return true; }}), "\'@\'")}))})})));
+
+		parser::frame_slot<ast::matcher_ptr > psFrame_psVal(psVal, psOut);
+		parser::frame_slot<ast::matcher_ptr > psFrame_m(m);
+		parser::frame_slot<std::string > psFrame_s(s);
+		return psRule(ps);
 	}
 
-	bool primary(parser::state& ps, ast::matcher_ptr & psVal) {
-		ast::alt_matcher_ptr  am;
-		ast::seq_matcher_ptr  bm;
-		ast::char_matcher_ptr  cm;
-		ast::range_matcher_ptr  rm;
-		std::string  s;
-		ast::str_matcher_ptr  sm;
+	bool primary(parser::state& ps, ast::matcher_ptr & psOut) {
+		static thread_local ast::matcher_ptr  psVal;
+		static thread_local ast::alt_matcher_ptr  am;
+		static thread_local ast::seq_matcher_ptr  bm;
+		static thread_local ast::char_matcher_ptr  cm;
+		static thread_local ast::range_matcher_ptr  rm;
+		static thread_local std::string  s;
+		static thread_local ast::str_matcher_ptr  sm;
 
-		return parser::memoize(13, psVal, 
+		static thread_local const parser::combinator psRule = parser::memoize(12, psVal, 
 			parser::choice({
 				parser::named("nonterminal expression", 
 					parser::sequence({
 						parser::look_not(parser::unbind(rule_lhs)),
 						parser::bind(s, identifier),
-						[&](parser::state& ps) { psVal = ast::make_ptr<ast::rule_matcher>(s);  return true; },
+						[](parser::state& ps) { psVal = ps.arena().make<ast::rule_matcher>(std::move(s));  return true; },
 						parser::option(
 							parser::sequence({
 								BIND,
 								parser::bind(s, identifier),
-								[&](parser::state& ps) { ast::as_ptr<ast::rule_matcher>(psVal)->var = s;  return true; }}))})),
-				parser::named("parenthesized subexpression", 
+								[](parser::state& ps) { ast::as_ptr<ast::rule_matcher>(psVal)->var = std::move(s);  return true; }}))})),
+				parser::guard(parser::charset{{0x00000000u, 0x00000100u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, parser::named("parenthesized subexpression", 
 					parser::sequence({
 						OPEN,
 						parser::bind(am, choice),
 						CLOSE,
-						[&](parser::state& ps) { psVal = am;  return true; }})),
-				
+						[](parser::state& ps) { psVal = am;  return true; }})), "\'(\'", "parenthesized subexpression"),
+				parser::guard(parser::charset{{0x00000000u, 0x00000080u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, 
 					parser::sequence({
 						parser::bind(cm, char_literal),
-						[&](parser::state& ps) { psVal = cm;  return true; }}),
-				
+						[](parser::state& ps) { psVal = cm;  return true; }}), "character literal"),
+				parser::guard(parser::charset{{0x00000000u, 0x00000004u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, 
 					parser::sequence({
 						parser::bind(sm, str_literal),
-						[&](parser::state& ps) { psVal = sm;  return true; }}),
-				
+						[](parser::state& ps) { psVal = sm;  return true; }}), "string literal"),
+				parser::guard(parser::charset{{0x00000000u, 0x00000000u, 0x08000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, 
 					parser::sequence({
 						parser::bind(rm, char_class),
-						[&](parser::state& ps) { psVal = rm;  return true; },
+						[](parser::state& ps) { psVal = rm;  return true; },
 						parser::option(
 							parser::sequence({
 								BIND,
 								parser::bind(s, identifier),
-								[&](parser::state& ps) { ast::as_ptr<ast::range_matcher>(psVal)->var = s;  return true; }}))}),
-				
+								[](parser::state& ps) { ast::as_ptr<ast::range_matcher>(psVal)->var = std::move(s);  return true; }}))}), "character class"),
+				parser::guard(parser::charset{{0x00000000u, 0x00004000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, 
 					parser::sequence({
 						ANY,
-						[&](parser::state& ps) { psVal = ast::make_ptr<ast::any_matcher>();  return true; },
+						[](parser::state& ps) { psVal = ps.arena().make<ast::any_matcher>();  return true; },
 						parser::option(
 							parser::sequence({
 								BIND,
 								parser::bind(s, identifier),
-								[&](parser::state& ps) { ast::as_ptr<ast::any_matcher>(psVal)->var = s;  return true; }}))}),
-				
+								[](parser::state& ps) { ast::as_ptr<ast::any_matcher>(psVal)->var = std::move(s);  return true; }}))}), "\'.\'"),
+				parser::guard(parser::charset{{0x00000000u, 0x08000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, 
 					parser::sequence({
 						EMPTY,
-						[&](parser::state& ps) { psVal = ast::make_ptr<ast::empty_matcher>();  return true; }}),
-				parser::named("capturing expression", 
+						[](parser::state& ps) { psVal = ps.arena().make<ast::empty_matcher>();  return true; }}), "\';\'"),
+				parser::guard(parser::charset{{0x00000000u, 0x00000000u, 0x40000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, 
+					parser::sequence({
+						CUT,
+						[](parser::state& ps) { psVal = ps.arena().make<ast::cut_matcher>();  return true; }}), "\'^\'"),
+				parser::guard(parser::charset{{0x00000000u, 0x10000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, parser::named("capturing expression", 
 					parser::sequence({
 						BEGIN,
 						parser::bind(bm, sequence),
 						END,
 						BIND,
 						parser::bind(s, identifier),
-						[&](parser::state& ps) { psVal = ast::make_ptr<ast::capt_matcher>(bm, s);  return true; }})),
-				
+						[](parser::state& ps) { psVal = ps.arena().make<ast::capt_matcher>(bm, std::move(s));  return true; }})), "\'<\'", "capturing expression"),
+				parser::guard(parser::charset{{0x00000000u, 0x00000000u, 0x00000001u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, 
 					parser::sequence({
 						EXPECT,
 						
 							parser::choice({
-								
+								parser::guard(parser::charset{{0x00000000u, 0x00000080u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, 
 									parser::sequence({
 										parser::bind(cm, char_literal),
-										[&](parser::state& ps) { psVal = ast::make_ptr<ast::named_matcher>(cm, strings::quoted_escape(cm->c));  return true; }}),
-								
+										[](parser::state& ps) { psVal = ps.arena().make<ast::named_matcher>(cm, strings::quoted_escape(cm->c));  return true; }}), "character literal"),
+								parser::guard(parser::charset{{0x00000000u, 0x00000004u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, 
 									parser::sequence({
 										parser::bind(sm, str_literal),
-										[&](parser::state& ps) { psVal = ast::make_ptr<ast::named_matcher>(sm, strings::quoted_escape(sm->s));  return true; }})})}),
-				
+										[](parser::state& ps) { psVal = ps.arena().make<ast::named_matcher>(sm, strings::quoted_escape(sm->s));  return true; }}), "string literal")})}), "\'@\'"),
+				parser::guard(parser::charset{{0x00000000u, 0x00000000u, 0x00000000u, 0x40000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, 
 					parser::sequence({
 						FAIL,
 						parser::bind(s, err_string),
-						[&](parser::state& ps) { psVal = ast::make_ptr<ast::fail_matcher>(s);  return true; }})}))(ps);
+						[](parser::state& ps) { psVal = ps.arena().make<ast::fail_matcher>(std::move(s));  return true; }}), "\'~\'")}));
+
+		parser::frame_slot<ast::matcher_ptr > psFrame_psVal(psVal, psOut);
+		parser::frame_slot<ast::alt_matcher_ptr > psFrame_am(am);
+		parser::frame_slot<ast::seq_matcher_ptr > psFrame_bm(bm);
+		parser::frame_slot<ast::char_matcher_ptr > psFrame_cm(cm);
+		parser::frame_slot<ast::range_matcher_ptr > psFrame_rm(rm);
+		parser::frame_slot<std::string > psFrame_s(s);
+		parser::frame_slot<ast::str_matcher_ptr > psFrame_sm(sm);
+		return psRule(ps);
 	}
 
-	bool action(parser::state& ps, ast::action_matcher_ptr & psVal) {
-		std::string s;
+	bool action(parser::state& ps, ast::action_matcher_ptr & psOut) {
+		static thread_local ast::action_matcher_ptr  psVal;
+		static thread_local std::string s;
 
-		return parser::memoize(14, psVal, parser::named("action", 
+		static thread_local const parser::combinator psRule = parser::memoize(13, psVal, parser::named("action", 
 			parser::sequence({
 				parser::look_not(OUT_BEGIN),
 				parser::literal('{'),
-				parser::capture(s, parser::memoize_many(15, 
+				parser::capture(s, parser::memoize_many(14, 
 					parser::choice({
 						parser::unbind(action),
 						
@@ -390,251 +467,1734 @@ namespace egg {
 								parser::any()})}))),
 				parser::literal('}'),
 				_,
-				[&](parser::state& ps) { psVal = ast::make_ptr<ast::action_matcher>(s);  return true; }})))(ps);
+				[](parser::state& ps) { psVal = ps.arena().make<ast::action_matcher>(std::move(s));  return true; }})));
+
+		parser::frame_slot<ast::action_matcher_ptr > psFrame_psVal(psVal, psOut);
+		parser::frame_slot<std::string> psFrame_s(s);
+		return psRule(ps);
 	}
 
-	bool char_literal(parser::state& ps, ast::char_matcher_ptr & psVal) {
-		char  c;
+	bool char_literal(parser::state& ps, ast::char_matcher_ptr & psOut) {
+		static thread_local ast::char_matcher_ptr  psVal;
+		static thread_local char  c;
 
-		return parser::memoize(16, psVal, parser::named("character literal", 
+		static thread_local const parser::combinator psRule = parser::memoize(15, psVal, parser::named("character literal", 
 			parser::sequence({
 				parser::literal('\''),
 				parser::bind(c, character),
 				parser::literal('\''),
 				_,
-				[&](parser::state& ps) { psVal = ast::make_ptr<ast::char_matcher>(c);  return true; }})))(ps);
+				[](parser::state& ps) { psVal = ps.arena().make<ast::char_matcher>(c);  return true; }})));
+
+		parser::frame_slot<ast::char_matcher_ptr > psFrame_psVal(psVal, psOut);
+		parser::frame_slot<char > psFrame_c(c);
+		return psRule(ps);
 	}
 
-	bool str_literal(parser::state& ps, ast::str_matcher_ptr & psVal) {
-		std::string s;
+	bool str_literal(parser::state& ps, ast::str_matcher_ptr & psOut) {
+		static thread_local ast::str_matcher_ptr  psVal;
+		static thread_local std::string s;
 
-		return parser::memoize(17, psVal, parser::named("string literal", 
+		static thread_local const parser::combinator psRule = parser::memoize(16, psVal, parser::named("string literal", 
 			parser::sequence({
 				parser::literal('\"'),
-				parser::capture(s, parser::memoize_many(18, parser::unbind(character))),
+				parser::capture(s, parser::memoize_many(17, parser::unbind(character))),
 				parser::literal('\"'),
 				_,
-				[&](parser::state& ps) { psVal = ast::make_ptr<ast::str_matcher>(strings::unescape(s));  return true; }})))(ps);
+				[](parser::state& ps) { psVal = ps.arena().make<ast::str_matcher>(strings::unescape(s));  return true; }})));
+
+		parser::frame_slot<ast::str_matcher_ptr > psFrame_psVal(psVal, psOut);
+		parser::frame_slot<std::string> psFrame_s(s);
+		return psRule(ps);
 	}
 
-	bool char_class(parser::state& ps, ast::range_matcher_ptr & psVal) {
-		ast::char_range  r;
+	bool char_class(parser::state& ps, ast::range_matcher_ptr & psOut) {
+		static thread_local ast::range_matcher_ptr  psVal;
+		static thread_local ast::char_range  r;
 
-		return parser::memoize(19, psVal, parser::named("character class", 
+		static thread_local const parser::combinator psRule = parser::memoize(18, psVal, parser::named("character class", 
 			parser::sequence({
 				parser::literal('['),
-				[&](parser::state& ps) { psVal = ast::make_ptr<ast::range_matcher>();  return true; },
+				[](parser::state& ps) { psVal = ps.arena().make<ast::range_matcher>();  return true; },
+				parser::option(
+					parser::sequence({
+						parser::literal('^'),
+						parser::look_not(parser::literal(']')),
+						[](parser::state& ps) { psVal->neg = true;  return true; }})),
 				parser::many(
 					parser::sequence({
 						parser::look_not(parser::literal(']')),
 						parser::bind(r, characters),
-						[&](parser::state& ps) { *psVal += r;  return true; }})),
+						[](parser::state& ps) { *psVal += r;  return true; }})),
 				parser::literal(']'),
-				_})))(ps);
+				_})));
+
+		parser::frame_slot<ast::range_matcher_ptr > psFrame_psVal(psVal, psOut);
+		parser::frame_slot<ast::char_range > psFrame_r(r);
+		return psRule(ps);
 	}
 
-	bool characters(parser::state& ps, ast::char_range & psVal) {
-		char  c;
-		char  f;
-		char  t;
+	bool characters(parser::state& ps, ast::char_range & psOut) {
+		static thread_local ast::char_range  psVal;
+		static thread_local char  c;
+		static thread_local char  f;
+		static thread_local char  t;
 
-		return parser::memoize(20, psVal, 
+		static thread_local const parser::combinator psRule = parser::memoize(19, psVal, 
 			parser::choice({
 				
 					parser::sequence({
 						parser::bind(f, character),
 						parser::literal('-'),
 						parser::bind(t, character),
-						[&](parser::state& ps) { psVal = ast::char_range(f,t);  return true; }}),
+						[](parser::state& ps) { psVal = ast::char_range(f,t);  return true; }}),
 				
 					parser::sequence({
 						parser::bind(c, character),
-						[&](parser::state& ps) { psVal = ast::char_range(c);  return true; }})}))(ps);
+						[](parser::state& ps) { psVal = ast::char_range(c);  return true; }})}));
+
+		parser::frame_slot<ast::char_range > psFrame_psVal(psVal, psOut);
+		parser::frame_slot<char > psFrame_c(c);
+		parser::frame_slot<char > psFrame_f(f);
+		parser::frame_slot<char > psFrame_t(t);
+		return psRule(ps);
 	}
 
-	bool character(parser::state& ps, char & psVal) {
-		char c;
+	bool character(parser::state& ps, char & psOut) {
+		static thread_local char  psVal;
+		static thread_local char c;
 
-		return parser::memoize(21, psVal, 
+		static thread_local const parser::combinator psRule = parser::memoize(20, psVal, 
 			parser::choice({
-				
+				parser::guard(parser::charset{{0x00000000u, 0x00000000u, 0x10000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, 
 					parser::sequence({
 						parser::literal('\\'),
-						
-							parser::choice({
-								parser::literal('n', c),
-								parser::literal('r', c),
-								parser::literal('t', c),
-								parser::literal('\'', c),
-								parser::literal('\"', c),
-								parser::literal('\\', c)}),
-						[&](parser::state& ps) { psVal = strings::unescaped_char(c);  return true; }}),
+						parser::in_set(parser::charset{{0x00000000u, 0x00000084u, 0x50000000u, 0x00144000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, c),
+						[](parser::state& ps) { psVal = strings::unescaped_char(c);  return true; }})),
 				
 					parser::sequence({
-						parser::look_not(
-							parser::choice({
-								parser::literal('\''),
-								parser::literal('\"'),
-								parser::literal('\\')})),
-						parser::any(psVal)})}))(ps);
+						parser::look_not(parser::in_set(parser::charset{{0x00000000u, 0x00000084u, 0x10000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}})),
+						parser::any(psVal)})}));
+
+		parser::frame_slot<char > psFrame_psVal(psVal, psOut);
+		parser::frame_slot<char> psFrame_c(c);
+		return psRule(ps);
 	}
 
 	bool OUT_BEGIN(parser::state& ps) {
-		return parser::memoize(22, parser::named("\"{%\"", parser::literal("{%")))(ps);
+
+		static thread_local const parser::combinator psRule = parser::memoize(21, parser::named("\"{%\"", parser::literal("{%")));
+
+		return psRule(ps);
 	}
 
 	bool OUT_END(parser::state& ps) {
-		return parser::memoize(23, parser::named("\"%}\"", parser::literal("%}")))(ps);
+
+		static thread_local const parser::combinator psRule = parser::memoize(22, parser::named("\"%}\"", parser::literal("%}")));
+
+		return psRule(ps);
 	}
 
 	bool BIND(parser::state& ps) {
-		return parser::memoize(24, 
-			parser::sequence({
-				parser::named("\':\'", parser::literal(':')),
-				_}))(ps);
+		static const std::uint8_t psClasses[] = {
+			0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 3, 1, 1, 4, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			5, 1, 1, 6, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 7, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+		static const std::uint16_t psTrans[] = {
+			1, 1, 1, 1, 1, 1, 1, 2,
+			3, 3, 4, 4, 5, 2, 6, 3,
+			7, 7, 8, 2, 9, 10, 11, 7,
+			3, 6, 6, 4, 12, 6, 6, 6,
+			7, 7, 8, 2, 9, 10, 11, 7};
+		static const parser::dfa_edge psEdges[] = {
+			{0, 0, 1},
+			{parser::dfa::stop, 1, 3},
+			{1, 3, 4},
+			{parser::dfa::stop, 4, 6},
+			{1, 6, 8},
+			{2, 8, 12},
+			{3, 12, 13},
+			{parser::dfa::stop, 13, 16},
+			{1, 16, 19},
+			{2, 19, 24},
+			{1, 24, 27},
+			{3, 27, 30},
+			{4, 30, 33}};
+		static const parser::dfa_op psOps[] = {
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 2},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::match_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::match_reg, 1, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 1},
+			{parser::dfa::record_at, 2, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::copy_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0}};
+		static const char* const psExpected[] = {
+			"\':\'"};
+		static const std::uint8_t psRuns[] = {
+			0, 1, 0, 2, 0};
+		static const parser::scan_set psRunSets[] = {
+			parser::scan_set{parser::charset{{0x00000600u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+			parser::scan_set{parser::charset{{0xffffdbfeu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu}}, {0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe, 0xff, 0xff, 0xfe, 0xff, 0xff}, {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}}};
+		static const parser::dfa psDfa = {psClasses, 8, psTrans, psEdges, psOps, psExpected, psRuns, psRunSets};
+
+		return ps.matches(psDfa);
 	}
 
 	bool EQUAL(parser::state& ps) {
-		return parser::memoize(25, 
-			parser::sequence({
-				parser::named("\'=\'", parser::literal('=')),
-				_}))(ps);
+		static const std::uint8_t psClasses[] = {
+			0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 3, 1, 1, 4, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			5, 1, 1, 6, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 7, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+		static const std::uint16_t psTrans[] = {
+			1, 1, 1, 1, 1, 1, 1, 2,
+			3, 3, 4, 4, 5, 2, 6, 3,
+			7, 7, 8, 2, 9, 10, 11, 7,
+			3, 6, 6, 4, 12, 6, 6, 6,
+			7, 7, 8, 2, 9, 10, 11, 7};
+		static const parser::dfa_edge psEdges[] = {
+			{0, 0, 1},
+			{parser::dfa::stop, 1, 3},
+			{1, 3, 4},
+			{parser::dfa::stop, 4, 6},
+			{1, 6, 8},
+			{2, 8, 12},
+			{3, 12, 13},
+			{parser::dfa::stop, 13, 16},
+			{1, 16, 19},
+			{2, 19, 24},
+			{1, 24, 27},
+			{3, 27, 30},
+			{4, 30, 33}};
+		static const parser::dfa_op psOps[] = {
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 2},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::match_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::match_reg, 1, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 1},
+			{parser::dfa::record_at, 2, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::copy_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0}};
+		static const char* const psExpected[] = {
+			"\'=\'"};
+		static const std::uint8_t psRuns[] = {
+			0, 1, 0, 2, 0};
+		static const parser::scan_set psRunSets[] = {
+			parser::scan_set{parser::charset{{0x00000600u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+			parser::scan_set{parser::charset{{0xffffdbfeu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu}}, {0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe, 0xff, 0xff, 0xfe, 0xff, 0xff}, {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}}};
+		static const parser::dfa psDfa = {psClasses, 8, psTrans, psEdges, psOps, psExpected, psRuns, psRunSets};
+
+		return ps.matches(psDfa);
 	}
 
 	bool PIPE(parser::state& ps) {
-		return parser::memoize(26, 
-			parser::sequence({
-				parser::named("\'|\'", parser::literal('|')),
-				_}))(ps);
+		static const std::uint8_t psClasses[] = {
+			0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 3, 1, 1, 4, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			5, 1, 1, 6, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 7, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+		static const std::uint16_t psTrans[] = {
+			1, 1, 1, 1, 1, 1, 1, 2,
+			3, 3, 4, 4, 5, 2, 6, 3,
+			7, 7, 8, 2, 9, 10, 11, 7,
+			3, 6, 6, 4, 12, 6, 6, 6,
+			7, 7, 8, 2, 9, 10, 11, 7};
+		static const parser::dfa_edge psEdges[] = {
+			{0, 0, 1},
+			{parser::dfa::stop, 1, 3},
+			{1, 3, 4},
+			{parser::dfa::stop, 4, 6},
+			{1, 6, 8},
+			{2, 8, 12},
+			{3, 12, 13},
+			{parser::dfa::stop, 13, 16},
+			{1, 16, 19},
+			{2, 19, 24},
+			{1, 24, 27},
+			{3, 27, 30},
+			{4, 30, 33}};
+		static const parser::dfa_op psOps[] = {
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 2},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::match_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::match_reg, 1, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 1},
+			{parser::dfa::record_at, 2, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::copy_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0}};
+		static const char* const psExpected[] = {
+			"\'|\'"};
+		static const std::uint8_t psRuns[] = {
+			0, 1, 0, 2, 0};
+		static const parser::scan_set psRunSets[] = {
+			parser::scan_set{parser::charset{{0x00000600u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+			parser::scan_set{parser::charset{{0xffffdbfeu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu}}, {0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe, 0xff, 0xff, 0xfe, 0xff, 0xff}, {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}}};
+		static const parser::dfa psDfa = {psClasses, 8, psTrans, psEdges, psOps, psExpected, psRuns, psRunSets};
+
+		return ps.matches(psDfa);
 	}
 
 	bool AND(parser::state& ps) {
-		return parser::memoize(27, 
-			parser::sequence({
-				parser::named("\'&\'", parser::literal('&')),
-				_}))(ps);
+		static const std::uint8_t psClasses[] = {
+			0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 3, 1, 1, 4, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			5, 1, 1, 6, 1, 1, 7, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+		static const std::uint16_t psTrans[] = {
+			1, 1, 1, 1, 1, 1, 1, 2,
+			3, 3, 4, 4, 5, 2, 6, 3,
+			7, 7, 8, 2, 9, 10, 11, 7,
+			3, 6, 6, 4, 12, 6, 6, 6,
+			7, 7, 8, 2, 9, 10, 11, 7};
+		static const parser::dfa_edge psEdges[] = {
+			{0, 0, 1},
+			{parser::dfa::stop, 1, 3},
+			{1, 3, 4},
+			{parser::dfa::stop, 4, 6},
+			{1, 6, 8},
+			{2, 8, 12},
+			{3, 12, 13},
+			{parser::dfa::stop, 13, 16},
+			{1, 16, 19},
+			{2, 19, 24},
+			{1, 24, 27},
+			{3, 27, 30},
+			{4, 30, 33}};
+		static const parser::dfa_op psOps[] = {
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 2},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::match_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::match_reg, 1, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 1},
+			{parser::dfa::record_at, 2, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::copy_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0}};
+		static const char* const psExpected[] = {
+			"\'&\'"};
+		static const std::uint8_t psRuns[] = {
+			0, 1, 0, 2, 0};
+		static const parser::scan_set psRunSets[] = {
+			parser::scan_set{parser::charset{{0x00000600u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+			parser::scan_set{parser::charset{{0xffffdbfeu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu}}, {0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe, 0xff, 0xff, 0xfe, 0xff, 0xff}, {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}}};
+		static const parser::dfa psDfa = {psClasses, 8, psTrans, psEdges, psOps, psExpected, psRuns, psRunSets};
+
+		return ps.matches(psDfa);
 	}
 
 	bool NOT(parser::state& ps) {
-		return parser::memoize(28, 
-			parser::sequence({
-				parser::named("\'!\'", parser::literal('!')),
-				_}))(ps);
+		static const std::uint8_t psClasses[] = {
+			0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 3, 1, 1, 4, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			5, 6, 1, 7, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+		static const std::uint16_t psTrans[] = {
+			1, 1, 1, 1, 1, 1, 2, 1,
+			3, 3, 4, 4, 5, 2, 3, 6,
+			7, 7, 8, 2, 9, 10, 7, 11,
+			3, 6, 6, 4, 12, 6, 6, 6,
+			7, 7, 8, 2, 9, 10, 7, 11};
+		static const parser::dfa_edge psEdges[] = {
+			{0, 0, 1},
+			{parser::dfa::stop, 1, 3},
+			{1, 3, 4},
+			{parser::dfa::stop, 4, 6},
+			{1, 6, 8},
+			{2, 8, 12},
+			{3, 12, 13},
+			{parser::dfa::stop, 13, 16},
+			{1, 16, 19},
+			{2, 19, 24},
+			{1, 24, 27},
+			{3, 27, 30},
+			{4, 30, 33}};
+		static const parser::dfa_op psOps[] = {
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 2},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::match_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::match_reg, 1, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 1},
+			{parser::dfa::record_at, 2, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::copy_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0}};
+		static const char* const psExpected[] = {
+			"\'!\'"};
+		static const std::uint8_t psRuns[] = {
+			0, 1, 0, 2, 0};
+		static const parser::scan_set psRunSets[] = {
+			parser::scan_set{parser::charset{{0x00000600u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+			parser::scan_set{parser::charset{{0xffffdbfeu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu}}, {0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe, 0xff, 0xff, 0xfe, 0xff, 0xff}, {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}}};
+		static const parser::dfa psDfa = {psClasses, 8, psTrans, psEdges, psOps, psExpected, psRuns, psRunSets};
+
+		return ps.matches(psDfa);
 	}
 
 	bool OPT(parser::state& ps) {
-		return parser::memoize(29, 
-			parser::sequence({
-				parser::named("\'?\'", parser::literal('?')),
-				_}))(ps);
+		static const std::uint8_t psClasses[] = {
+			0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 3, 1, 1, 4, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			5, 1, 1, 6, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 7,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+		static const std::uint16_t psTrans[] = {
+			1, 1, 1, 1, 1, 1, 1, 2,
+			3, 3, 4, 4, 5, 2, 6, 3,
+			7, 7, 8, 2, 9, 10, 11, 7,
+			3, 6, 6, 4, 12, 6, 6, 6,
+			7, 7, 8, 2, 9, 10, 11, 7};
+		static const parser::dfa_edge psEdges[] = {
+			{0, 0, 1},
+			{parser::dfa::stop, 1, 3},
+			{1, 3, 4},
+			{parser::dfa::stop, 4, 6},
+			{1, 6, 8},
+			{2, 8, 12},
+			{3, 12, 13},
+			{parser::dfa::stop, 13, 16},
+			{1, 16, 19},
+			{2, 19, 24},
+			{1, 24, 27},
+			{3, 27, 30},
+			{4, 30, 33}};
+		static const parser::dfa_op psOps[] = {
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 2},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::match_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::match_reg, 1, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 1},
+			{parser::dfa::record_at, 2, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::copy_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0}};
+		static const char* const psExpected[] = {
+			"\'?\'"};
+		static const std::uint8_t psRuns[] = {
+			0, 1, 0, 2, 0};
+		static const parser::scan_set psRunSets[] = {
+			parser::scan_set{parser::charset{{0x00000600u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+			parser::scan_set{parser::charset{{0xffffdbfeu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu}}, {0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe, 0xff, 0xff, 0xfe, 0xff, 0xff}, {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}}};
+		static const parser::dfa psDfa = {psClasses, 8, psTrans, psEdges, psOps, psExpected, psRuns, psRunSets};
+
+		return ps.matches(psDfa);
 	}
 
 	bool STAR(parser::state& ps) {
-		return parser::memoize(30, 
-			parser::sequence({
-				parser::named("\'*\'", parser::literal('*')),
-				_}))(ps);
+		static const std::uint8_t psClasses[] = {
+			0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 3, 1, 1, 4, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			5, 1, 1, 6, 1, 1, 1, 1, 1, 1, 7, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+		static const std::uint16_t psTrans[] = {
+			1, 1, 1, 1, 1, 1, 1, 2,
+			3, 3, 4, 4, 5, 2, 6, 3,
+			7, 7, 8, 2, 9, 10, 11, 7,
+			3, 6, 6, 4, 12, 6, 6, 6,
+			7, 7, 8, 2, 9, 10, 11, 7};
+		static const parser::dfa_edge psEdges[] = {
+			{0, 0, 1},
+			{parser::dfa::stop, 1, 3},
+			{1, 3, 4},
+			{parser::dfa::stop, 4, 6},
+			{1, 6, 8},
+			{2, 8, 12},
+			{3, 12, 13},
+			{parser::dfa::stop, 13, 16},
+			{1, 16, 19},
+			{2, 19, 24},
+			{1, 24, 27},
+			{3, 27, 30},
+			{4, 30, 33}};
+		static const parser::dfa_op psOps[] = {
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 2},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::match_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::match_reg, 1, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 1},
+			{parser::dfa::record_at, 2, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::copy_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0}};
+		static const char* const psExpected[] = {
+			"\'*\'"};
+		static const std::uint8_t psRuns[] = {
+			0, 1, 0, 2, 0};
+		static const parser::scan_set psRunSets[] = {
+			parser::scan_set{parser::charset{{0x00000600u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+			parser::scan_set{parser::charset{{0xffffdbfeu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu}}, {0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe, 0xff, 0xff, 0xfe, 0xff, 0xff}, {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}}};
+		static const parser::dfa psDfa = {psClasses, 8, psTrans, psEdges, psOps, psExpected, psRuns, psRunSets};
+
+		return ps.matches(psDfa);
 	}
 
 	bool PLUS(parser::state& ps) {
-		return parser::memoize(31, 
-			parser::sequence({
-				parser::named("\'+\'", parser::literal('+')),
-				_}))(ps);
+		static const std::uint8_t psClasses[] = {
+			0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 3, 1, 1, 4, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			5, 1, 1, 6, 1, 1, 1, 1, 1, 1, 1, 7, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+		static const std::uint16_t psTrans[] = {
+			1, 1, 1, 1, 1, 1, 1, 2,
+			3, 3, 4, 4, 5, 2, 6, 3,
+			7, 7, 8, 2, 9, 10, 11, 7,
+			3, 6, 6, 4, 12, 6, 6, 6,
+			7, 7, 8, 2, 9, 10, 11, 7};
+		static const parser::dfa_edge psEdges[] = {
+			{0, 0, 1},
+			{parser::dfa::stop, 1, 3},
+			{1, 3, 4},
+			{parser::dfa::stop, 4, 6},
+			{1, 6, 8},
+			{2, 8, 12},
+			{3, 12, 13},
+			{parser::dfa::stop, 13, 16},
+			{1, 16, 19},
+			{2, 19, 24},
+			{1, 24, 27},
+			{3, 27, 30},
+			{4, 30, 33}};
+		static const parser::dfa_op psOps[] = {
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 2},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::match_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::match_reg, 1, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 1},
+			{parser::dfa::record_at, 2, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::copy_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0}};
+		static const char* const psExpected[] = {
+			"\'+\'"};
+		static const std::uint8_t psRuns[] = {
+			0, 1, 0, 2, 0};
+		static const parser::scan_set psRunSets[] = {
+			parser::scan_set{parser::charset{{0x00000600u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+			parser::scan_set{parser::charset{{0xffffdbfeu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu}}, {0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe, 0xff, 0xff, 0xfe, 0xff, 0xff}, {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}}};
+		static const parser::dfa psDfa = {psClasses, 8, psTrans, psEdges, psOps, psExpected, psRuns, psRunSets};
+
+		return ps.matches(psDfa);
 	}
 
 	bool OPEN(parser::state& ps) {
-		return parser::memoize(32, 
-			parser::sequence({
-				parser::named("\'(\'", parser::literal('(')),
-				_}))(ps);
+		static const std::uint8_t psClasses[] = {
+			0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 3, 1, 1, 4, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			5, 1, 1, 6, 1, 1, 1, 1, 7, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+		static const std::uint16_t psTrans[] = {
+			1, 1, 1, 1, 1, 1, 1, 2,
+			3, 3, 4, 4, 5, 2, 6, 3,
+			7, 7, 8, 2, 9, 10, 11, 7,
+			3, 6, 6, 4, 12, 6, 6, 6,
+			7, 7, 8, 2, 9, 10, 11, 7};
+		static const parser::dfa_edge psEdges[] = {
+			{0, 0, 1},
+			{parser::dfa::stop, 1, 3},
+			{1, 3, 4},
+			{parser::dfa::stop, 4, 6},
+			{1, 6, 8},
+			{2, 8, 12},
+			{3, 12, 13},
+			{parser::dfa::stop, 13, 16},
+			{1, 16, 19},
+			{2, 19, 24},
+			{1, 24, 27},
+			{3, 27, 30},
+			{4, 30, 33}};
+		static const parser::dfa_op psOps[] = {
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 2},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::match_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::match_reg, 1, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 1},
+			{parser::dfa::record_at, 2, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::copy_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0}};
+		static const char* const psExpected[] = {
+			"\'(\'"};
+		static const std::uint8_t psRuns[] = {
+			0, 1, 0, 2, 0};
+		static const parser::scan_set psRunSets[] = {
+			parser::scan_set{parser::charset{{0x00000600u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+			parser::scan_set{parser::charset{{0xffffdbfeu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu}}, {0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe, 0xff, 0xff, 0xfe, 0xff, 0xff}, {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}}};
+		static const parser::dfa psDfa = {psClasses, 8, psTrans, psEdges, psOps, psExpected, psRuns, psRunSets};
+
+		return ps.matches(psDfa);
 	}
 
 	bool CLOSE(parser::state& ps) {
-		return parser::memoize(33, 
-			parser::sequence({
-				parser::named("\')\'", parser::literal(')')),
-				_}))(ps);
+		static const std::uint8_t psClasses[] = {
+			0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 3, 1, 1, 4, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			5, 1, 1, 6, 1, 1, 1, 1, 1, 7, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+		static const std::uint16_t psTrans[] = {
+			1, 1, 1, 1, 1, 1, 1, 2,
+			3, 3, 4, 4, 5, 2, 6, 3,
+			7, 7, 8, 2, 9, 10, 11, 7,
+			3, 6, 6, 4, 12, 6, 6, 6,
+			7, 7, 8, 2, 9, 10, 11, 7};
+		static const parser::dfa_edge psEdges[] = {
+			{0, 0, 1},
+			{parser::dfa::stop, 1, 3},
+			{1, 3, 4},
+			{parser::dfa::stop, 4, 6},
+			{1, 6, 8},
+			{2, 8, 12},
+			{3, 12, 13},
+			{parser::dfa::stop, 13, 16},
+			{1, 16, 19},
+			{2, 19, 24},
+			{1, 24, 27},
+			{3, 27, 30},
+			{4, 30, 33}};
+		static const parser::dfa_op psOps[] = {
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 2},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::match_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::match_reg, 1, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 1},
+			{parser::dfa::record_at, 2, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::copy_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0}};
+		static const char* const psExpected[] = {
+			"\')\'"};
+		static const std::uint8_t psRuns[] = {
+			0, 1, 0, 2, 0};
+		static const parser::scan_set psRunSets[] = {
+			parser::scan_set{parser::charset{{0x00000600u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+			parser::scan_set{parser::charset{{0xffffdbfeu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu}}, {0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe, 0xff, 0xff, 0xfe, 0xff, 0xff}, {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}}};
+		static const parser::dfa psDfa = {psClasses, 8, psTrans, psEdges, psOps, psExpected, psRuns, psRunSets};
+
+		return ps.matches(psDfa);
 	}
 
 	bool ANY(parser::state& ps) {
-		return parser::memoize(34, 
-			parser::sequence({
-				parser::named("\'.\'", parser::literal('.')),
-				_}))(ps);
+		static const std::uint8_t psClasses[] = {
+			0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 3, 1, 1, 4, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			5, 1, 1, 6, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 7, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+		static const std::uint16_t psTrans[] = {
+			1, 1, 1, 1, 1, 1, 1, 2,
+			3, 3, 4, 4, 5, 2, 6, 3,
+			7, 7, 8, 2, 9, 10, 11, 7,
+			3, 6, 6, 4, 12, 6, 6, 6,
+			7, 7, 8, 2, 9, 10, 11, 7};
+		static const parser::dfa_edge psEdges[] = {
+			{0, 0, 1},
+			{parser::dfa::stop, 1, 3},
+			{1, 3, 4},
+			{parser::dfa::stop, 4, 6},
+			{1, 6, 8},
+			{2, 8, 12},
+			{3, 12, 13},
+			{parser::dfa::stop, 13, 16},
+			{1, 16, 19},
+			{2, 19, 24},
+			{1, 24, 27},
+			{3, 27, 30},
+			{4, 30, 33}};
+		static const parser::dfa_op psOps[] = {
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 2},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::match_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::match_reg, 1, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 1},
+			{parser::dfa::record_at, 2, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::copy_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0}};
+		static const char* const psExpected[] = {
+			"\'.\'"};
+		static const std::uint8_t psRuns[] = {
+			0, 1, 0, 2, 0};
+		static const parser::scan_set psRunSets[] = {
+			parser::scan_set{parser::charset{{0x00000600u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+			parser::scan_set{parser::charset{{0xffffdbfeu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu}}, {0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe, 0xff, 0xff, 0xfe, 0xff, 0xff}, {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}}};
+		static const parser::dfa psDfa = {psClasses, 8, psTrans, psEdges, psOps, psExpected, psRuns, psRunSets};
+
+		return ps.matches(psDfa);
 	}
 
 	bool EMPTY(parser::state& ps) {
-		return parser::memoize(35, 
-			parser::sequence({
-				parser::named("\';\'", parser::literal(';')),
-				_}))(ps);
+		static const std::uint8_t psClasses[] = {
+			0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 3, 1, 1, 4, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			5, 1, 1, 6, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 7, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+		static const std::uint16_t psTrans[] = {
+			1, 1, 1, 1, 1, 1, 1, 2,
+			3, 3, 4, 4, 5, 2, 6, 3,
+			7, 7, 8, 2, 9, 10, 11, 7,
+			3, 6, 6, 4, 12, 6, 6, 6,
+			7, 7, 8, 2, 9, 10, 11, 7};
+		static const parser::dfa_edge psEdges[] = {
+			{0, 0, 1},
+			{parser::dfa::stop, 1, 3},
+			{1, 3, 4},
+			{parser::dfa::stop, 4, 6},
+			{1, 6, 8},
+			{2, 8, 12},
+			{3, 12, 13},
+			{parser::dfa::stop, 13, 16},
+			{1, 16, 19},
+			{2, 19, 24},
+			{1, 24, 27},
+			{3, 27, 30},
+			{4, 30, 33}};
+		static const parser::dfa_op psOps[] = {
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 2},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::match_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::match_reg, 1, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 1},
+			{parser::dfa::record_at, 2, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::copy_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0}};
+		static const char* const psExpected[] = {
+			"\';\'"};
+		static const std::uint8_t psRuns[] = {
+			0, 1, 0, 2, 0};
+		static const parser::scan_set psRunSets[] = {
+			parser::scan_set{parser::charset{{0x00000600u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+			parser::scan_set{parser::charset{{0xffffdbfeu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu}}, {0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe, 0xff, 0xff, 0xfe, 0xff, 0xff}, {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}}};
+		static const parser::dfa psDfa = {psClasses, 8, psTrans, psEdges, psOps, psExpected, psRuns, psRunSets};
+
+		return ps.matches(psDfa);
 	}
 
 	bool BEGIN(parser::state& ps) {
-		return parser::memoize(36, 
-			parser::sequence({
-				parser::named("\'<\'", parser::literal('<')),
-				_}))(ps);
+		static const std::uint8_t psClasses[] = {
+			0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 3, 1, 1, 4, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			5, 1, 1, 6, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 7, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+		static const std::uint16_t psTrans[] = {
+			1, 1, 1, 1, 1, 1, 1, 2,
+			3, 3, 4, 4, 5, 2, 6, 3,
+			7, 7, 8, 2, 9, 10, 11, 7,
+			3, 6, 6, 4, 12, 6, 6, 6,
+			7, 7, 8, 2, 9, 10, 11, 7};
+		static const parser::dfa_edge psEdges[] = {
+			{0, 0, 1},
+			{parser::dfa::stop, 1, 3},
+			{1, 3, 4},
+			{parser::dfa::stop, 4, 6},
+			{1, 6, 8},
+			{2, 8, 12},
+			{3, 12, 13},
+			{parser::dfa::stop, 13, 16},
+			{1, 16, 19},
+			{2, 19, 24},
+			{1, 24, 27},
+			{3, 27, 30},
+			{4, 30, 33}};
+		static const parser::dfa_op psOps[] = {
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 2},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::match_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::match_reg, 1, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 1},
+			{parser::dfa::record_at, 2, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::copy_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0}};
+		static const char* const psExpected[] = {
+			"\'<\'"};
+		static const std::uint8_t psRuns[] = {
+			0, 1, 0, 2, 0};
+		static const parser::scan_set psRunSets[] = {
+			parser::scan_set{parser::charset{{0x00000600u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+			parser::scan_set{parser::charset{{0xffffdbfeu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu}}, {0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe, 0xff, 0xff, 0xfe, 0xff, 0xff}, {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}}};
+		static const parser::dfa psDfa = {psClasses, 8, psTrans, psEdges, psOps, psExpected, psRuns, psRunSets};
+
+		return ps.matches(psDfa);
 	}
 
 	bool END(parser::state& ps) {
-		return parser::memoize(37, 
-			parser::sequence({
-				parser::named("\'>\'", parser::literal('>')),
-				_}))(ps);
+		static const std::uint8_t psClasses[] = {
+			0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 3, 1, 1, 4, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			5, 1, 1, 6, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 7, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+		static const std::uint16_t psTrans[] = {
+			1, 1, 1, 1, 1, 1, 1, 2,
+			3, 3, 4, 4, 5, 2, 6, 3,
+			7, 7, 8, 2, 9, 10, 11, 7,
+			3, 6, 6, 4, 12, 6, 6, 6,
+			7, 7, 8, 2, 9, 10, 11, 7};
+		static const parser::dfa_edge psEdges[] = {
+			{0, 0, 1},
+			{parser::dfa::stop, 1, 3},
+			{1, 3, 4},
+			{parser::dfa::stop, 4, 6},
+			{1, 6, 8},
+			{2, 8, 12},
+			{3, 12, 13},
+			{parser::dfa::stop, 13, 16},
+			{1, 16, 19},
+			{2, 19, 24},
+			{1, 24, 27},
+			{3, 27, 30},
+			{4, 30, 33}};
+		static const parser::dfa_op psOps[] = {
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 2},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::match_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::match_reg, 1, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 1},
+			{parser::dfa::record_at, 2, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::copy_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0}};
+		static const char* const psExpected[] = {
+			"\'>\'"};
+		static const std::uint8_t psRuns[] = {
+			0, 1, 0, 2, 0};
+		static const parser::scan_set psRunSets[] = {
+			parser::scan_set{parser::charset{{0x00000600u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+			parser::scan_set{parser::charset{{0xffffdbfeu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu}}, {0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe, 0xff, 0xff, 0xfe, 0xff, 0xff}, {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}}};
+		static const parser::dfa psDfa = {psClasses, 8, psTrans, psEdges, psOps, psExpected, psRuns, psRunSets};
+
+		return ps.matches(psDfa);
 	}
 
 	bool EXPECT(parser::state& ps) {
-		return parser::memoize(38, 
-			parser::sequence({
-				parser::named("\'@\'", parser::literal('@')),
-				_}))(ps);
+		static const std::uint8_t psClasses[] = {
+			0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 3, 1, 1, 4, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			5, 1, 1, 6, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			7, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+		static const std::uint16_t psTrans[] = {
+			1, 1, 1, 1, 1, 1, 1, 2,
+			3, 3, 4, 4, 5, 2, 6, 3,
+			7, 7, 8, 2, 9, 10, 11, 7,
+			3, 6, 6, 4, 12, 6, 6, 6,
+			7, 7, 8, 2, 9, 10, 11, 7};
+		static const parser::dfa_edge psEdges[] = {
+			{0, 0, 1},
+			{parser::dfa::stop, 1, 3},
+			{1, 3, 4},
+			{parser::dfa::stop, 4, 6},
+			{1, 6, 8},
+			{2, 8, 12},
+			{3, 12, 13},
+			{parser::dfa::stop, 13, 16},
+			{1, 16, 19},
+			{2, 19, 24},
+			{1, 24, 27},
+			{3, 27, 30},
+			{4, 30, 33}};
+		static const parser::dfa_op psOps[] = {
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 2},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::match_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::match_reg, 1, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 1},
+			{parser::dfa::record_at, 2, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::copy_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0}};
+		static const char* const psExpected[] = {
+			"\'@\'"};
+		static const std::uint8_t psRuns[] = {
+			0, 1, 0, 2, 0};
+		static const parser::scan_set psRunSets[] = {
+			parser::scan_set{parser::charset{{0x00000600u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+			parser::scan_set{parser::charset{{0xffffdbfeu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu}}, {0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe, 0xff, 0xff, 0xfe, 0xff, 0xff}, {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}}};
+		static const parser::dfa psDfa = {psClasses, 8, psTrans, psEdges, psOps, psExpected, psRuns, psRunSets};
+
+		return ps.matches(psDfa);
 	}
 
 	bool FAIL(parser::state& ps) {
-		return parser::memoize(39, 
-			parser::sequence({
-				parser::named("\'~\'", parser::literal('~')),
-				_}))(ps);
+		static const std::uint8_t psClasses[] = {
+			0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 3, 1, 1, 4, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			5, 1, 1, 6, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 7, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+		static const std::uint16_t psTrans[] = {
+			1, 1, 1, 1, 1, 1, 1, 2,
+			3, 3, 4, 4, 5, 2, 6, 3,
+			7, 7, 8, 2, 9, 10, 11, 7,
+			3, 6, 6, 4, 12, 6, 6, 6,
+			7, 7, 8, 2, 9, 10, 11, 7};
+		static const parser::dfa_edge psEdges[] = {
+			{0, 0, 1},
+			{parser::dfa::stop, 1, 3},
+			{1, 3, 4},
+			{parser::dfa::stop, 4, 6},
+			{1, 6, 8},
+			{2, 8, 12},
+			{3, 12, 13},
+			{parser::dfa::stop, 13, 16},
+			{1, 16, 19},
+			{2, 19, 24},
+			{1, 24, 27},
+			{3, 27, 30},
+			{4, 30, 33}};
+		static const parser::dfa_op psOps[] = {
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 2},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::match_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::match_reg, 1, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 1},
+			{parser::dfa::record_at, 2, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::copy_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0}};
+		static const char* const psExpected[] = {
+			"\'~\'"};
+		static const std::uint8_t psRuns[] = {
+			0, 1, 0, 2, 0};
+		static const parser::scan_set psRunSets[] = {
+			parser::scan_set{parser::charset{{0x00000600u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+			parser::scan_set{parser::charset{{0xffffdbfeu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu}}, {0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe, 0xff, 0xff, 0xfe, 0xff, 0xff}, {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}}};
+		static const parser::dfa psDfa = {psClasses, 8, psTrans, psEdges, psOps, psExpected, psRuns, psRunSets};
+
+		return ps.matches(psDfa);
+	}
+
+	bool CUT(parser::state& ps) {
+		static const std::uint8_t psClasses[] = {
+			0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 3, 1, 1, 4, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			5, 1, 1, 6, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 7, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+		static const std::uint16_t psTrans[] = {
+			1, 1, 1, 1, 1, 1, 1, 2,
+			3, 3, 4, 4, 5, 2, 6, 3,
+			7, 7, 8, 2, 9, 10, 11, 7,
+			3, 6, 6, 4, 12, 6, 6, 6,
+			7, 7, 8, 2, 9, 10, 11, 7};
+		static const parser::dfa_edge psEdges[] = {
+			{0, 0, 1},
+			{parser::dfa::stop, 1, 3},
+			{1, 3, 4},
+			{parser::dfa::stop, 4, 6},
+			{1, 6, 8},
+			{2, 8, 12},
+			{3, 12, 13},
+			{parser::dfa::stop, 13, 16},
+			{1, 16, 19},
+			{2, 19, 24},
+			{1, 24, 27},
+			{3, 27, 30},
+			{4, 30, 33}};
+		static const parser::dfa_op psOps[] = {
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 2},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::match_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::match_reg, 1, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 1},
+			{parser::dfa::record_at, 2, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::copy_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0}};
+		static const char* const psExpected[] = {
+			"\'^\'"};
+		static const std::uint8_t psRuns[] = {
+			0, 1, 0, 2, 0};
+		static const parser::scan_set psRunSets[] = {
+			parser::scan_set{parser::charset{{0x00000600u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+			parser::scan_set{parser::charset{{0xffffdbfeu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu}}, {0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe, 0xff, 0xff, 0xfe, 0xff, 0xff}, {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}}};
+		static const parser::dfa psDfa = {psClasses, 8, psTrans, psEdges, psOps, psExpected, psRuns, psRunSets};
+
+		return ps.matches(psDfa);
 	}
 
 	bool _(parser::state& ps) {
-		return parser::memoize(40, parser::memoize_many(41, 
-			parser::choice({
-				space,
-				comment})))(ps);
+		static const std::uint8_t psClasses[] = {
+			0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 3, 1, 1, 4, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			5, 1, 1, 6, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+		static const std::uint16_t psTrans[] = {
+			1, 1, 2, 2, 3, 0, 4,
+			5, 5, 6, 0, 7, 8, 9,
+			1, 4, 4, 2, 10, 4, 4,
+			5, 5, 6, 0, 7, 8, 9};
+		static const parser::dfa_edge psEdges[] = {
+			{0, 0, 1},
+			{parser::dfa::stop, 1, 3},
+			{0, 3, 5},
+			{1, 5, 9},
+			{2, 9, 10},
+			{parser::dfa::stop, 10, 13},
+			{0, 13, 16},
+			{1, 16, 21},
+			{0, 21, 24},
+			{2, 24, 27},
+			{3, 27, 30}};
+		static const parser::dfa_op psOps[] = {
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::match_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::match_reg, 1, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 1},
+			{parser::dfa::record_at, 2, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 0},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::copy_reg, 0, 1},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::copy_reg, 2, 0}};
+		static const std::uint8_t psRuns[] = {
+			1, 0, 2, 0};
+		static const parser::scan_set psRunSets[] = {
+			parser::scan_set{parser::charset{{0x00000600u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+			parser::scan_set{parser::charset{{0xffffdbfeu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu}}, {0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe, 0xff, 0xff, 0xfe, 0xff, 0xff}, {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}}};
+		static const parser::dfa psDfa = {psClasses, 7, psTrans, psEdges, psOps, nullptr, psRuns, psRunSets};
+
+		return ps.matches(psDfa);
 	}
 
 	bool space(parser::state& ps) {
-		return parser::memoize(42, 
+
+		static thread_local const parser::combinator psRule = parser::memoize(23, 
 			parser::choice({
-				parser::literal(' '),
-				parser::literal('\t'),
-				end_of_line}))(ps);
+				[](parser::state& ps) -> bool {
+					switch ( ps() ) {
+					case '\t':
+						ps.fail(); ps += 1; return true;
+					case ' ':
+						ps += 1; return true;
+					default:
+						ps.fail(); return false;
+					}
+				},
+				parser::guard(parser::charset{{0x00002400u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u}}, end_of_line)}));
+
+		return psRule(ps);
 	}
 
 	bool comment(parser::state& ps) {
-		return parser::memoize(43, 
-			parser::sequence({
-				parser::literal('#'),
-				parser::memoize_many(44, 
-					parser::sequence({
-						parser::look_not(end_of_line),
-						parser::any()})),
-				end_of_line}))(ps);
+		static const std::uint8_t psClasses[] = {
+			0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 1, 1, 3, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 4, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+			1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+		static const std::uint16_t psTrans[] = {
+			1, 1, 1, 1, 2,
+			1, 3, 4, 5, 3,
+			6, 6, 7, 6, 6};
+		static const parser::dfa_edge psEdges[] = {
+			{0, 0, 0},
+			{parser::dfa::stop, 0, 1},
+			{1, 1, 1},
+			{1, 1, 2},
+			{parser::dfa::stop, 2, 4},
+			{2, 4, 6},
+			{parser::dfa::stop, 6, 9},
+			{parser::dfa::stop, 9, 10}};
+		static const parser::dfa_op psOps[] = {
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::record_at, 1, 1},
+			{parser::dfa::match_at, 0, 0},
+			{parser::dfa::set_reg, 0, 1},
+			{parser::dfa::set_reg, 1, 0},
+			{parser::dfa::record_at, 2, 1},
+			{parser::dfa::record_reg, 0, 1},
+			{parser::dfa::match_reg, 1, 0},
+			{parser::dfa::match_at, 0, 0}};
+		static const std::uint8_t psRuns[] = {
+			0, 1, 0};
+		static const parser::scan_set psRunSets[] = {
+			parser::scan_set{parser::charset{{0xffffdbfeu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu}}, {0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe, 0xff, 0xff, 0xfe, 0xff, 0xff}, {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff}}};
+		static const parser::dfa psDfa = {psClasses, 5, psTrans, psEdges, psOps, nullptr, psRuns, psRunSets};
+
+		return ps.matches(psDfa);
 	}
 
 	bool end_of_line(parser::state& ps) {
-		return parser::memoize(45, 
-			parser::choice({
-				parser::literal("\r\n"),
-				parser::literal('\n'),
-				parser::literal('\r')}))(ps);
+
+		static thread_local const parser::combinator psRule = parser::memoize(24, [](parser::state& ps) -> bool {
+			switch ( ps() ) {
+			case '\n':
+				ps.fail(); ps += 1; return true;
+			case '\r':
+				switch ( ps.peek(1) ) {
+				case '\n':
+					ps += 2; return true;
+				default:
+					ps.fail(); ps += 1; return true;
+				}
+			default:
+				ps.fail(); return false;
+			}
+		});
+
+		return psRule(ps);
 	}
 
 	bool end_of_file(parser::state& ps) {
-		return parser::memoize(46, parser::named("end of input", parser::look_not(parser::any())))(ps);
+
+		static thread_local const parser::combinator psRule = parser::memoize(25, parser::named("end of input", parser::look_not(parser::any())));
+
+		return psRule(ps);
 	}
 
 } // namespace egg
@@ -24,12 +24,16 @@
 #include <cctype>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <string>
 
 #include "egg.hpp"
+#include "mapped_file.hpp"
 #include "parser.hpp"
 #include "visitors/compiler.hpp"
+#include "visitors/cutter.hpp"
+#include "visitors/generator.hpp"
 #include "visitors/normalizer.hpp"
 #include "visitors/printer.hpp"
 
@@ -38,8 +42,8 @@ static const char* VERSION = "0.3.2";
 
 /** Egg usage string */
 static const char* USAGE = 
-"[-c print|compile] [-i input_file] [-o output_file]\n\
- [--dbg] [--no-norm] [--no-memo] [--quiet] [--help] [--version] [--usage]";
+"[-c print|compile] [-i input_file] [-o output_file] [-b combinator|templates|direct]\n\
+ [--dbg] [--no-norm] [--no-memo] [--auto-cut] [--no-errors] [--quiet] [--help] [--version] [--usage]";
 
 /** Full Egg help string */
 static const char* HELP = 
@@ -53,10 +57,18 @@ Supported flags are\n\
  -n --name     grammar name - if none given, takes the longest prefix of\n\
                the input or output file name (output preferred) which is a\n\
                valid Egg identifier (default empty)\n\
+ -b --backend  code generation backend - either combinator, which builds\n\
+               parser combinators, templates, which builds statically-typed\n\
+               parser combinators, or direct, which generates plain\n\
+               recursive-descent code (default combinator)\n\
  -q --quiet    suppress warning output\n\
  --dbg         turn on debugging\n\
  --no-norm     turns off grammar normalization\n\
  --no-memo     turns of grammar memoization\n\
+ --auto-cut    inserts cuts where the parser can never backtrack, bounding\n\
+               the memory used by the generated parser\n\
+ --no-errors   generated parser reports only the position of a parse\n\
+               error, not the expected strings or error messages\n\
  --usage       print usage message\n\
  --help        print full help message\n\
  --version     print version string\n";
@@ -70,6 +82,13 @@ enum egg_mode {
 	VERSION_MODE   ///< Print version
 };
 
+/// Code generation backend
+enum egg_backend {
+	COMBINATOR_BACKEND,  ///< Generate parser combinators
+	TEMPLATES_BACKEND,   ///< Generate statically-typed parser combinators
+	DIRECT_BACKEND       ///< Generate recursive-descent code directly
+};
+
 /// Type of output file
 enum file_type {
 	STREAM_TYPE,  ///< Output stream (unknown filetype)
@@ -146,8 +165,18 @@ private:
 		}
 	}
 
+	void parse_backend(char* s) {
+		if ( eq("combinator", s) ) {
+			eBackend = COMBINATOR_BACKEND;
+		} else if ( eq("templates", s) ) {
+			eBackend = TEMPLATES_BACKEND;
+		} else if ( eq("direct", s) ) {
+			eBackend = DIRECT_BACKEND;
+		}
+	}
+
 	void parse_input(char* s) {
-		in = new std::ifstream(s);
+		in = new parser::mapped_file(s);
 		inName = s;
 		if ( !nameFlag && out == nullptr ) {
 			pName = id_prefix(s);
@@ -172,8 +201,9 @@ public:
 	args(int argc, char** argv) 
 		: in(nullptr), out(nullptr), 
 		  inName(), outName(), outType(STREAM_TYPE), pName(), 
-		  dbgFlag(false), nameFlag(false), normFlag(true), memoFlag(true), quietFlag(false),
-		  eMode(COMPILE_MODE) {
+		  dbgFlag(false), nameFlag(false), normFlag(true), memoFlag(true), cutFlag(false),
+		  errFlag(true), quietFlag(false),
+		  eMode(COMPILE_MODE), eBackend(COMBINATOR_BACKEND) {
 		
 		i = 1;
 		if ( argc <= 1 ) return;
@@ -195,12 +225,19 @@ public:
 			} else if ( match("-n", "--name", argv[i]) ) {
 				if ( i+1 >= argc ) return;
 				parse_name(argv[++i]);
+			} else if ( match("-b", "--backend", argv[i]) ) {
+				if ( i+1 >= argc ) return;
+				parse_backend(argv[++i]);
 			} else if ( eq("--dbg", argv[i]) ) {
 				dbgFlag = true;
 			} else if ( eq("--no-norm", argv[i]) ) {
 				normFlag = false;
 			} else if ( eq("--no-memo", argv[i]) ) {
 				memoFlag = false;
+			} else if ( eq("--auto-cut", argv[i]) ) {
+				cutFlag = true;
+			} else if ( eq("--no-errors", argv[i]) ) {
+				errFlag = false;
 			} else if ( match("-i", "--quiet", argv[i]) ) {
 				quietFlag = true;
 			} else if ( eq("--usage", argv[i]) ) {
@@ -218,11 +255,11 @@ public:
 	}
 
 	~args() {
-		if ( in != nullptr ) { in->close(); delete in; }
+		if ( in != nullptr ) { delete in; }
 		if ( out != nullptr ) { out->close(); delete out; }
 	}
 
-	std::istream& input() { if ( in ) return *in; else return std::cin; }
+	parser::mapped_file* input() { return in; }
 	std::ostream& output() { if ( out ) return *out; else return std::cout; }
 	std::string inputFile() { return in ? inName : "<STDIN>"; }
 	std::string outputFile() { return out ? outName : "<STDOUT>"; }
@@ -231,12 +268,15 @@ public:
 	bool dbg()  { return dbgFlag; }
 	bool norm() { return normFlag; }
 	bool memo() { return memoFlag; }
+	bool cut()  { return cutFlag; }
+	bool errors() { return errFlag; }
 	bool quiet() { return quietFlag; }
 	egg_mode mode() { return eMode; }
+	egg_backend backend() { return eBackend; }
 
 private:
 	int i;				  ///< next unparsed value
-	std::ifstream* in;	  ///< pointer to input stream (0 for stdin)
+	parser::mapped_file* in; ///< pointer to input file (0 for stdin)
 	std::ofstream* out;	  ///< pointer to output stream (0 for stdout)
 	std::string inName;   ///< Name of the input file (empty if none)
 	std::string outName;  ///< Name of the output file (empty if none)
@@ -246,8 +286,11 @@ private:
 	bool nameFlag;		  ///< has the parser name been explicitly set?
 	bool normFlag;        ///< should egg do grammar normalization?
 	bool memoFlag;        ///< should the generated grammar do memoization?
+	bool cutFlag;         ///< should egg insert cuts into the grammar?
+	bool errFlag;         ///< should the generated grammar report error strings?
 	bool quietFlag;       ///< should warnings be suppressed?
 	egg_mode eMode;		  ///< compiler mode to use
+	egg_backend eBackend; ///< code generation backend to use
 };
 
 /** Command line interface
@@ -270,15 +313,31 @@ int main(int argc, char** argv) {
 	default: break;
 	}
 	
-	parser::state ps(a.input());
+	// Parse input files in place, falling back to reading stdin
+	std::unique_ptr<parser::state> pps( a.input() ? 
+		new parser::state(a.input()->data(), a.input()->size()) : 
+		new parser::state(std::cin) );
+	parser::state& ps = *pps;
 	ast::grammar_ptr g;
 	
-	if ( egg::grammar(ps, g) ) {
+	bool parsed;
+	try {
+		parsed = egg::grammar(ps, g);
+	} catch (const parser::forgotten_state_error&) {
+		// backtracked past a cut; report as a parse failure
+		parsed = false;
+	}
+	
+	if ( parsed ) {
 		if ( a.dbg() ) { std::cout << "DONE PARSING" << std::endl; }
 		if ( a.norm() ) {
 			visitor::normalizer n;
 			n.normalize(*g);
 		}
+		if ( a.cut() ) {
+			visitor::cutter c;
+			c.cut(*g);
+		}
 
 		switch ( a.mode() ) {
 		case PRINT_MODE: {      // Pretty-print grammar
@@ -286,9 +345,19 @@ int main(int argc, char** argv) {
 			p.print(*g);
 			break;
 		} case COMPILE_MODE: {  // Compile grammar
-			visitor::compiler c(a.name(), a.output(), (a.outputType() != CPP_SOURCE));
-			c.memo(a.memo());
-			auto warnings = c.compile(*g);
+			visitor::compiler::warning_list warnings;
+			if ( a.backend() == DIRECT_BACKEND ) {
+				visitor::generator c(a.name(), a.output(), (a.outputType() != CPP_SOURCE));
+				c.memo(a.memo());
+				c.errors(a.errors());
+				warnings = c.compile(*g);
+			} else {
+				visitor::compiler c(a.name(), a.output(), (a.outputType() != CPP_SOURCE));
+				c.memo(a.memo());
+				c.errors(a.errors());
+				c.templates(a.backend() == TEMPLATES_BACKEND);
+				warnings = c.compile(*g);
+			}
 			if ( ! a.quiet() ) for ( auto&& warning : warnings ) {
 				std::cerr << "WARNING: " << warning << std::endl;
 			}
@@ -0,0 +1,117 @@
+#pragma once
+
+/*
+ * Copyright (c) 2013 Aaron Moss
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/** Memory-mapped file input for Egg parsers (POSIX).
+ *  
+ *  @author Aaron Moss
+ */
+
+namespace parser {
+	
+	/** Read-only view of the contents of a file.
+	 *  Regular files are memory-mapped; anything which cannot be mapped (pipes, 
+	 *  empty files, etc.) is read into memory instead. The contents can be 
+	 *  parsed in place by `parser::state ps(f.data(), f.size());`; the 
+	 *  mapped_file must outlive any parser state using it.
+	 */
+	class mapped_file {
+	public:
+		typedef char           value_type;
+		typedef unsigned long  ind;
+		
+		/** Opens and maps the given file.
+		 *  If the file cannot be opened, the view will be empty, and is_open() 
+		 *  will be false.
+		 *  @param path		The path of the file to map
+		 */
+		mapped_file(const std::string& path) 
+				: p(nullptr), n(0), opened(false), mapped(false), copy() {
+			int fd = ::open(path.c_str(), O_RDONLY);
+			if ( fd < 0 ) return;
+			opened = true;
+			
+			// Map regular files
+			struct stat st;
+			if ( ::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 ) {
+				void* m = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+				if ( m != MAP_FAILED ) {
+					::madvise(m, st.st_size, MADV_SEQUENTIAL);
+					p = static_cast<const value_type*>(m);
+					n = st.st_size;
+					mapped = true;
+				}
+			}
+			
+			// Fall back to reading the file
+			if ( ! mapped ) {
+				value_type b[4096];
+				ssize_t r;
+				while ( (r = ::read(fd, b, sizeof(b))) > 0 ) {
+					copy.insert(copy.end(), b, b + r);
+				}
+				p = copy.data();
+				n = copy.size();
+			}
+			
+			::close(fd);
+		}
+		
+		mapped_file(const mapped_file&) = delete;
+		mapped_file& operator = (const mapped_file&) = delete;
+		
+		~mapped_file() {
+			if ( mapped ) ::munmap(const_cast<value_type*>(p), n);
+		}
+		
+		/** @return the beginning of the file contents */
+		const value_type* data() const { return p; }
+		
+		/** @return the number of characters in the file */
+		ind size() const { return n; }
+		
+		/** @return was the file successfully opened? */
+		bool is_open() const { return opened; }
+		
+		/** @return are the file contents memory-mapped (rather than copied)? */
+		bool is_mapped() const { return mapped; }
+		
+	private:
+		const value_type* p;          ///< Beginning of the file contents
+		ind n;                        ///< Size of the file contents
+		bool opened;                  ///< Was the file opened?
+		bool mapped;                  ///< Is p a memory-mapped region?
+		std::vector<value_type> copy; ///< File contents, if not mapped
+	}; /* class mapped_file */
+	
+} /* namespace parser */
+
@@ -22,17 +22,29 @@
  * THE SOFTWARE.
  */
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <deque>
 #include <functional>
 #include <initializer_list>
 #include <istream>
+#include <memory>
+#include <mutex>
+#include <new>
 #include <set>
 #include <sstream>
 #include <stdexcept>
 #include <string>
-#include <typeinfo>
-#include <unordered_map>
+#include <type_traits>
+#include <unordered_set>
 #include <utility>
+#include <vector>
+
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+#define PARSER_SCAN_X86 1
+#include <immintrin.h>
+#endif
 
 /** Implements parser state for an Egg parser.
  *  
@@ -43,7 +55,11 @@ namespace parser {
 	
 	typedef unsigned long ind;  /**< unsigned index type */
 	
-	/** Human-readable position type */
+	/** Human-readable position type.
+	 *  Positions are tracked by index alone as the parser runs; their line and column are 
+	 *  only known once resolved by the parser state (see state::resolve()), as error 
+	 *  positions are.
+	 */
 	struct posn {
 	friend class state;
 	private:
@@ -70,9 +86,9 @@ namespace parser {
 		
 		/** @return the character index */
 		ind index() const { return i; }
-		/** @return the line in the file */
+		/** @return the line in the file, if resolved */
 		ind line() const { return ln; }
-		/** @return the column in the file */
+		/** @return the column in the file, if resolved */
 		ind col() const { return cl; }
 		
 	private:
@@ -114,6 +130,18 @@ namespace parser {
 		std::set<std::string> messages;  /**< Error messages */
 	}; // struct error
 	
+	/** Interns an error string, for parsers which must report errors by pointers to strings 
+	 *  which outlive the parser state.
+	 *  @param s		The string to intern
+	 *  @return A copy of s which lives as long as the program; equal strings share a copy
+	 */
+	inline const char* intern(const std::string& s) {
+		static std::mutex m;
+		static std::unordered_set<std::string> ss;
+		std::lock_guard<std::mutex> lock(m);
+		return ss.insert(s).first->c_str();
+	}
+	
 	/** Error thrown when a parser is asked for state it has forgotten. */
 	struct forgotten_state_error : public std::range_error {
 		
@@ -129,8 +157,7 @@ namespace parser {
 		const char* what() const throw() {
 			try {
 				std::stringstream ss("Forgotten state error");
-				ss << ": requested " << req.line() << ":" << req.col() 
-				   << " < " << avail.line() << ":" << avail.col();
+				ss << ": requested index " << req.index() << " < " << avail.index();
 				return ss.str().c_str();
 			} catch (std::exception const& e) {
 				return "Forgotten state error";
@@ -143,142 +170,627 @@ namespace parser {
 		posn avail;
 	}; /* struct forgotten_range_error */
 	
-	/** Memoization table entry */
-	struct memo {
-		/** Typesafe dynamic type */
-		class any {
-		private:
-			/** Untyped container class */
-			struct dyn {
-				virtual ~dyn() {}
-	
-				/** Gets the type of the held object */
-				virtual const std::type_info& type() const = 0;
-	
-				/** Copies the held object */
-				virtual dyn* clone() const = 0;
-			};  // struct dyn
-
-			/** Typed container class */
-			template <typename T>
-			struct of : public dyn {
-				/** Value constructor */
-				of (const T& v) : v(v) {}
+	/** Error thrown when a parser fed its input incrementally (see state::feed()) needs 
+	 *  input which has not been fed yet; that is, when it inspects a character past the 
+	 *  input fed so far, not merely when it consumes the last character fed. Nothing the parser has recorded is invalidated, 
+	 *  so once more input is fed (or the input finished) the parse may be resumed by 
+	 *  returning to a position kept by the caller and invoking the rule again; rules which 
+	 *  had already matched are recalled from the memoization table, if memoized. A retry 
+	 *  runs the semantic actions of the pending item again, so they must be idempotent. */
+	struct incomplete_input_error : public std::runtime_error {
+		
+		/** Default constructor.
+		 *  @param end		The end of the input fed so far
+		 */
+		incomplete_input_error(const posn& end) throw() 
+			: std::runtime_error("Incomplete input error"), end(end) {}
+		
+		/** end of the input fed so far */
+		posn end;
+	}; /* struct incomplete_input_error */
+	
+	/** Set of characters, stored as a 256-bit membership table.
+	 *  Aggregate-initialized from eight 32-bit words, least significant bit of the first word 
+	 *  standing for character 0.
+	 */
+	struct charset {
+		/** @return is c in the set? */
+		bool operator() (char c) const {
+			unsigned char u = c;
+			return (bits[u >> 5] >> (u & 31)) & 1;
+		}
+		
+		std::uint32_t bits[8];  ///< Membership bits
+	}; // struct charset
 	
-				/** Gets the type of the held object */
-				virtual const std::type_info& type() const { return typeid(T); }
+	/** Set of characters prepared for scanning the input for runs of its members a block at a 
+	 *  time; alongside the membership table, the set is split into two 16-entry tables indexed 
+	 *  by the low nibble of a character, where bit h of an entry stands for high nibble h (of 
+	 *  the lower or upper eight high nibbles), suitable for vector byte shuffles.
+	 *  Aggregate-initialized, normally from a table computed by the code generator.
+	 */
+	struct scan_set {
+		/** @return is c in the set? */
+		bool operator() (char c) const { return cs(c); }
+		
+		charset cs;           ///< Membership table
+		std::uint8_t lo[16];  ///< Characters with high nibbles 0-7, by low nibble
+		std::uint8_t hi[16];  ///< Characters with high nibbles 8-15, by low nibble
+	}; // struct scan_set
 	
-				/** Returns a copy of the held object */
-				virtual dyn* clone() const { return new of<T>(v); }
+	/** Scans for the end of a run of characters in a set, one character at a time.
+	 *  @return the first character in [b, e) not in s, or e if none
+	 */
+	inline const char* scan_scalar(const scan_set& s, const char* b, const char* e) {
+		while ( b != e && s.cs(*b) ) ++b;
+		return b;
+	}
 	
-				/** The held value */	
-				const T v;
-			};  // struct of<T>
+#ifdef PARSER_SCAN_X86
+	/** Scans for the end of a run of characters in a set 16 characters at a time, by SSSE3 
+	 *  table lookup; only valid if the processor supports SSSE3.
+	 *  @return the first character in [b, e) not in s, or e if none
+	 */
+	__attribute__((target("ssse3")))
+	inline const char* scan_ssse3(const scan_set& s, const char* b, const char* e) {
+		const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s.lo));
+		const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s.hi));
+		const __m128i bit = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 
+		                                  1, 2, 4, 8, 16, 32, 64, -128);
+		const __m128i nib = _mm_set1_epi8(0x0f);
 		
-		public:
-			/** Empty constructor */
-			any() : p(nullptr) {}
-
-			/** Typed constructor */
-			template <typename T>
-			any(const T& t) : p(new of<T>(t)) {}
-
-			/** Copy constructor */
-			any(const any& o) : p(o.p ? o.p->clone() : nullptr) {}
-
-			/** Assignment operator */
-			any& operator = (const any& o) {
-				if ( &o != this ) {
-					delete p;
-					p = o.p ? o.p->clone() : nullptr;
+		for (; e - b >= 16; b += 16) {
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+			__m128i vl = _mm_and_si128(v, nib);
+			__m128i vh = _mm_and_si128(_mm_srli_epi16(v, 4), nib);
+			// row of the table for each character, selected by the high bit of the character
+			__m128i up = _mm_cmplt_epi8(v, _mm_setzero_si128());
+			__m128i row = _mm_or_si128(_mm_andnot_si128(up, _mm_shuffle_epi8(lo, vl)), 
+			                           _mm_and_si128(up, _mm_shuffle_epi8(hi, vl)));
+			__m128i b8 = _mm_shuffle_epi8(bit, vh);
+			__m128i in = _mm_cmpeq_epi8(_mm_and_si128(row, b8), b8);
+			unsigned m = ~unsigned(_mm_movemask_epi8(in)) & 0xffffu;
+			if ( m != 0 ) return b + __builtin_ctz(m);
+		}
+		return scan_scalar(s, b, e);
+	}
+	
+	/** Scans for the end of a run of characters in a set 32 characters at a time, by AVX2 
+	 *  table lookup; only valid if the processor supports AVX2.
+	 *  @return the first character in [b, e) not in s, or e if none
+	 */
+	__attribute__((target("avx2")))
+	inline const char* scan_avx2(const scan_set& s, const char* b, const char* e) {
+		const __m256i lo = _mm256_broadcastsi128_si256(
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(s.lo)));
+		const __m256i hi = _mm256_broadcastsi128_si256(
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(s.hi)));
+		const __m256i bit = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 
+		                                     1, 2, 4, 8, 16, 32, 64, -128, 
+		                                     1, 2, 4, 8, 16, 32, 64, -128, 
+		                                     1, 2, 4, 8, 16, 32, 64, -128);
+		const __m256i nib = _mm256_set1_epi8(0x0f);
+		
+		for (; e - b >= 32; b += 32) {
+			__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+			__m256i vl = _mm256_and_si256(v, nib);
+			__m256i vh = _mm256_and_si256(_mm256_srli_epi16(v, 4), nib);
+			// row of the table for each character, selected by the high bit of the character
+			__m256i row = _mm256_blendv_epi8(_mm256_shuffle_epi8(lo, vl), 
+			                                 _mm256_shuffle_epi8(hi, vl), v);
+			__m256i b8 = _mm256_shuffle_epi8(bit, vh);
+			__m256i in = _mm256_cmpeq_epi8(_mm256_and_si256(row, b8), b8);
+			unsigned m = ~unsigned(_mm256_movemask_epi8(in));
+			if ( m != 0 ) return b + __builtin_ctz(m);
+		}
+		return scan_ssse3(s, b, e);
+	}
+#endif
+	
+	/** Scanning kernel type */
+	typedef const char* (*scan_kernel)(const scan_set&, const char*, const char*);
+	
+	/** @return the fastest scanning kernel supported by the processor, chosen on first use */
+	inline scan_kernel best_scan_kernel() {
+#ifdef PARSER_SCAN_X86
+		static const scan_kernel k = __builtin_cpu_supports("avx2") ? scan_avx2 
+			: __builtin_cpu_supports("ssse3") ? scan_ssse3 : scan_scalar;
+		return k;
+#else
+		return scan_scalar;
+#endif
+	}
+	
+	/** Scans for the end of a run of characters in a set.
+	 *  Short runs are common, so the first few characters are tested before dispatching to 
+	 *  a block-at-a-time kernel.
+	 *  @return the first character in [b, e) not in s, or e if none
+	 */
+	inline const char* scan(const scan_set& s, const char* b, const char* e) {
+		const char* m = ( e - b > 8 ) ? b + 8 : e;
+		for (; b != m; ++b) {
+			if ( ! s.cs(*b) ) return b;
+		}
+		return ( b == e ) ? e : best_scan_kernel()(s, b, e);
+	}
+	
+	/** Operation run on a transition of a parser::dfa */
+	struct dfa_op {
+		std::uint8_t op;  ///< Operation code, one of the dfa::op_code values
+		std::uint8_t a;   ///< Register or offset operand
+		std::uint32_t b;  ///< Register, offset, or error mask operand
+	}; // struct dfa_op
+	
+	/** Transition of a parser::dfa */
+	struct dfa_edge {
+		std::uint16_t to;     ///< State to move to, or dfa::stop if the match is decided
+		std::uint16_t begin;  ///< Index of the first operation run on the transition
+		std::uint16_t end;    ///< Index past the last operation run on the transition
+	}; // struct dfa_edge
+	
+	/** Deterministic automaton matching a lexical rule, as compiled by the code generator.
+	 *  Each transition reads one character (end of input reads as '\0'), and may record the
+	 *  furthest error seen or save input positions in registers; the position a match ends
+	 *  at may have been passed by the time the match is decided, so is taken from a register
+	 *  or an offset from the current position. Error masks have bit 0 for an unexplained
+	 *  error and bit k for the k'th expected string. A state may skip a run of characters
+	 *  which all take the same transition back to it, if taking that transition for the
+	 *  last two characters of the run has the same effect as taking it for all of them.
+	 *  Aggregate-initialized, normally from tables computed by the code generator.
+	 */
+	struct dfa {
+		/** Operation codes; offsets count back from the position after the character read */
+		enum op_code : std::uint8_t {
+			record_at,  ///< Record error mask b at offset a
+			record_reg, ///< Record error mask b at the position in register a
+			set_reg,    ///< Set register a to offset b, from the next transition on
+			copy_reg,   ///< Set register a to register b, from the next transition on
+			match_at,   ///< Match to offset a
+			match_reg   ///< Match to the position in register a
+		};
+		/** Target of a transition on which the match is decided */
+		static const std::uint16_t stop = 0xFFFF;
+		/** Maximum number of registers */
+		static const ind max_regs = 8;
+		
+		const std::uint8_t* classes;   ///< Class of each character
+		ind n_classes;                 ///< Number of character classes
+		const std::uint16_t* trans;    ///< Edge by state and character class
+		const dfa_edge* edges;         ///< Transitions; the first is taken before any input
+		const dfa_op* ops;             ///< Operations of the transitions
+		const char* const* expected;   ///< Expected strings, by error mask bit less one
+		const std::uint8_t* runs;      ///< Run of each state, as an index plus one, or 0
+		const scan_set* run_sets;      ///< Characters of each run
+	}; // struct dfa
+	
+	/** Packed memoization table entry: 0 for no entry, 1 for a failed match, 
+	 *  or 2 plus the length of a successful match */
+	typedef std::uint32_t memo_cell;
+	
+	/** Limits on the memory used by a parser's memoization table.
+	 *  Entries are evicted oldest input position first, at page granularity; 
+	 *  a parser with evicted entries recomputes them rather than failing.
+	 */
+	struct memo_policy {
+		memo_policy(ind window = 0, ind budget = 0) : window(window), budget(budget) {}
+		
+		ind window;  ///< Number of input positions behind the position being memoized 
+		             ///< to keep entries for [0 for unlimited]
+		ind budget;  ///< Approximate maximum bytes used by entries [0 for unlimited]
+	}; // struct memo_policy
+	
+	/** Memoization table usage counters */
+	struct memo_stats {
+		memo_stats() : hits(0), misses(0), evictions(0), bytes(0) {}
+		
+		ind hits;       ///< Number of lookups which found an entry
+		ind misses;     ///< Number of lookups which did not find an entry
+		ind evictions;  ///< Number of entries discarded by the memo_policy
+		ind bytes;      ///< Approximate bytes currently used by entries
+	}; // struct memo_stats
+	
+	/** Region allocator for values built by a parse, such as syntax trees. 
+	 *  Values are placed one after another in large blocks, and all destroyed together 
+	 *  when the arena is cleared or destroyed; there is no per-value ownership or 
+	 *  reference count, so values refer to each other by plain pointers, which are valid 
+	 *  for the life of the arena (and survive moving it). Each parser state has an arena, 
+	 *  state::arena(), which semantic actions may build their results in. */
+	class arena {
+		/** Size of the first block allocated */
+		static const ind min_block = 4096;
+		/** Largest block allocated, other than for a single large value */
+		static const ind max_block = 1048576;
+		
+		/** A block of storage */
+		struct block {
+			std::unique_ptr<char[]> p;  ///< The storage
+			ind n;                      ///< Number of bytes of storage
+		};
+		
+		/** A value to destroy when the arena is cleared */
+		struct cleanup {
+			void (*destroy)(void*);  ///< Destroys the value
+			void* p;                 ///< The value
+			cleanup* next;           ///< The value allocated before, if any
+		};
+		
+		template <typename T>
+		static void destroy(void* p) { static_cast<T*>(p)->~T(); }
+		
+		/** Allocates uninitialized storage.
+		 *  @param n		The number of bytes to allocate
+		 *  @param a		The alignment of the storage (no greater than that of 
+		 *  				std::max_align_t)
+		 */
+		void* alloc(ind n, ind a) {
+			while ( true ) {
+				if ( k < blocks.size() ) {
+					ind i = (used + a - 1) & ~(a - 1);
+					if ( i + n <= blocks[k].n ) {
+						used = i + n;
+						return blocks[k].p.get() + i;
+					}
+					// skip to the next block, or allocate one if there are no more
+					if ( k + 1 < blocks.size() ) { ++k; used = 0; continue; }
 				}
-				return *this;
-			}
-
-			/** Typed assignment operator */
-			template <typename T>
-			any& operator = (const T& v) {
-				delete p;
-				p = new of<T>(v);
-				return *this;
+				
+				ind bn = blocks.empty() ? min_block : 2 * blocks.back().n;
+				if ( bn > max_block ) bn = max_block;
+				if ( bn < n ) bn = n;
+				blocks.push_back(block{std::unique_ptr<char[]>(new char[bn]), bn});
+				k = blocks.size() - 1;
+				used = 0;
 			}
-
-			/** Contained type */
-			const std::type_info& type() const {
-				return p ? p->type() : typeid(void);
+		}
+		
+	public:
+		arena() : blocks(), k(0), used(0), values(nullptr) {}
+		
+		arena(arena&& o) : blocks(std::move(o.blocks)), k(o.k), used(o.used), values(o.values) {
+			o.blocks.clear();
+			o.k = o.used = 0;
+			o.values = nullptr;
+		}
+		
+		arena& operator= (arena&& o) {
+			if ( this == &o ) return *this;
+			clear();
+			blocks = std::move(o.blocks); k = o.k; used = o.used; values = o.values;
+			o.blocks.clear();
+			o.k = o.used = 0;
+			o.values = nullptr;
+			return *this;
+		}
+		
+		arena(const arena&) = delete;
+		arena& operator= (const arena&) = delete;
+		
+		~arena() { clear(); }
+		
+		/** Constructs a value in the arena.
+		 *  @param args		The constructor arguments
+		 *  @return the value, which lives until the arena is cleared or destroyed
+		 */
+		template <typename T, typename... Args>
+		T* make(Args&&... args) {
+			if ( std::is_trivially_destructible<T>::value ) {
+				return new (alloc(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
 			}
-
-			/** Bind value */
-			template <typename T>
-			void bind(T& v) {
-				if ( type() == typeid(T) ) {
-					v = static_cast<of<T>*>(p)->v;
-				}
+			
+			// allocate the cleanup first, so a failure cannot leave a value undestroyed
+			cleanup* c = static_cast<cleanup*>(alloc(sizeof(cleanup), alignof(cleanup)));
+			T* t = new (alloc(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+			values = new (c) cleanup{&destroy<T>, t, values};
+			return t;
+		}
+		
+		/** Destroys all values in the arena, most recent first, keeping its blocks 
+		 *  for reuse. */
+		void clear() {
+			while ( values ) {
+				cleanup* c = values;
+				values = c->next;
+				c->destroy(c->p);
 			}
-
-			~any() { delete p; }
-
-		private:
-			dyn* p;
-		};  // class memo::any
+			k = used = 0;
+		}
 		
-		/** Default constructor - sets up a failed match */
-		memo() : success(false) {}
+		/** @return the number of bytes of storage held by the arena */
+		ind capacity() const {
+			ind n = 0;
+			for (const block& b : blocks) n += b.n;
+			return n;
+		}
+		
+	private:
+		std::vector<block> blocks;  ///< Storage, in order of use
+		ind k;                      ///< Index of the block in use
+		ind used;                   ///< Bytes used of the block in use
+		cleanup* values;            ///< The last value allocated which needs destruction
+	}; /* class arena */
 	
-		/** Success constructor */
-		template <typename T>
-		memo(const posn& end, const T& result) : success(true), end(end), result(result) {}
+	class state;
 	
-		bool success;  ///< Did the parser match?
-		posn end;      ///< Endpoint in case of a match
-		any result;    ///< Result object (if any)
-	};
+	/** View of a captured range of the input, which does not copy it.
+	 *  Refers to the input by index, so remains valid as the parser reads 
+	 *  further input, for as long as the parser state which captured it.
+	 *  Bound by captures into a variable of this type, e.g. the psVal of a 
+	 *  rule declared `: parser::span`.
+	 */
+	class span {
+	friend class state;
+	private:
+		// constructor only available to state
+		span(const state* ps, ind i, ind n) : ps(ps), i(i), n(n) {}
+	public:
+		typedef char               value_type;
+		typedef const value_type*  iterator;
+		
+		span() : ps(nullptr), i(0), n(0) {}
+		
+		/** @return the captured characters (not null-terminated) */
+		inline const value_type* data() const;
+		
+		iterator begin() const { return data(); }
+		iterator end() const { return data() + n; }
+		
+		/** @return the number of characters captured */
+		ind size() const { return n; }
+		
+		/** @return was the empty string captured? */
+		bool empty() const { return n == 0; }
+		
+		/** @return the j'th captured character */
+		value_type operator[] (ind j) const { return data()[j]; }
+		
+		/** @return a copy of the captured characters */
+		std::string str() const { return std::string(begin(), end()); }
+		
+		operator std::string () const { return str(); }
+		
+		/** Compares the captured characters to a string */
+		bool operator == (const std::string& s) const {
+			return s.size() == n && std::memcmp(data(), s.data(), n) == 0;
+		}
+		
+		bool operator != (const std::string& s) const { return !(*this == s); }
+		
+	private:
+		const state* ps;  /**< parser state holding the input */
+		ind i;            /**< input index of the start of the capture */
+		ind n;            /**< number of characters captured */
+	}; /* class span */
 	
 	/** Parser state */
 	class state {
+	friend class span;
 	public:
 		typedef char                              value_type;
 		typedef std::basic_string<value_type>     string_type;
 		typedef std::basic_istream<value_type>    stream_type;
-		typedef std::deque<value_type>::iterator  iterator;
+		typedef const value_type*                 iterator;
 		typedef std::pair<iterator, iterator>     range_type;
 	
 	private:
-		/** Read a single character into the parser.
+		/** Initial and maximum number of characters to read from the input 
+		 *  stream at once; the read size doubles on each read between them, so 
+		 *  short inputs stay cheap and long inputs take few large reads. */
+		static const ind min_read = 64;
+		static const ind max_read = 65536;
+		
+		/** Read more characters into the parser, for a parser which needs to 
+		 *  inspect them.
+		 *  @param n		The minimum number of characters to read; more may be read
+		 *  @return The number of characters read (always 0 when parsing an 
+		 *          in-memory region)
+		 *  @throws incomplete_input_error if there are no characters to read, 
+		 *          but more input may yet be fed
+		 */
+		ind read(ind n) {
+			if ( in == nullptr ) { at_end(); return 0; }
+			return fill(n);
+		}
+		
+		/** Read more characters into the parser from the input stream, if any, 
+		 *  without requiring them; used to read ahead of the cursor as it advances.
+		 *  @param n		The minimum number of characters to read; more may be read
+		 *  @return The number of characters read (always 0 when parsing an 
+		 *          in-memory region or fed input)
+		 */
+		ind fill(ind n) {
+			if ( in == nullptr ) return 0;
+			
+			if ( n < chunk ) n = chunk;
+			if ( chunk < max_read ) chunk *= 2;
+			
+			compact();
+			
+			// Read directly onto the end of the stored input
+			ind old = str.size();
+			str.resize(old + n);
+			in->read(&str[old], n);
+			// Count read characters
+			ind r = in->gcount();
+			str.resize(old + r);
+			// Update view of the stored input
+			buf = str.data() + cut_len;
+			len = str.size() - cut_len;
+			return r;
+		}
+		
+		/** Read at least a single character into the parser.
 		 *  @return was a character read?
 		 */
-		bool read() {
-			int c = in.get();
+		bool read() { return read(1) > 0; }
+		
+		/** Checks that the end of the stored input is the end of the input.
+		 *  @throws incomplete_input_error if more input may yet be fed
+		 */
+		void at_end() const {
+			if ( more ) throw incomplete_input_error(parser::posn(off.i + len, 0, 0));
+		}
+		
+		/** Drops input discarded by cuts from the stored input, once it is most of it */
+		void compact() {
+			if ( cut_len > 0 && cut_len >= len ) {
+				str.erase(str.begin(), str.begin() + cut_len);
+				cut_len = 0;
+			}
+		}
+		
+		/** Discards all input, line, memoization, and error state, keeping the 
+		 *  memory allocated for it; the caller sets up the new input. */
+		void clear() {
+			pos = off = parser::posn();
+			str.clear();
+			cut_len = 0;
+			lines.clear();
+			lines.push_back(0);
+			scanned = 0;
 			
-			// Check EOF
-			if ( c == std::char_traits<value_type>::eof() ) return false;
+			// empty every page, keeping them for reuse
+			for (auto& col : memo_table) {
+				for (memo_cell* page : col.cells) {
+					if ( page == nullptr ) continue;
+					std::fill(page, page + memo_page_size, memo_cell(0));
+					memo_unused.push_back(page);
+				}
+				col.cells.clear();
+				if ( col.results ) col.results->clear();
+			}
+			memo_low = 0;
+			memo_count = parser::memo_stats();
 			
-			// Check newline
-			if ( c == '\n' ) lines.push_back(off.i + str.size() + 1);
+			fail_pos = parser::posn();
+			notes.clear();
+			note_strs.clear();
 			
-			// Add to stored input
-			str.push_back(c);
-			return true;
+			chunk = min_read;
+			store.clear();
 		}
 		
-		/** Read more characters into the parser.
-		 *  @param n		The number of characters to read
-		 *  @return The number of characters read
+		/** Number of consecutive input indices whose memoization entries for a 
+		 *  single parser are allocated together. Entries are sparse, so small 
+		 *  pages keep the table compact while still sharing cache lines. */
+		static const ind memo_page_size = 32;
+		/** Number of memoization entries allocated at once */
+		static const ind memo_block_size = 65536;
+		
+		/** Discards all memoization table entries for pages of input indices 
+		 *  before the given page; their pages are kept for reuse.
+		 *  @param pg       The first page to keep
 		 */
-		ind read(ind n) {
-			value_type s[n];
-			// Read into buffer
-			in.read(s, n);
-			// Count read characters
-			ind r = in.gcount();
-			// Track newlines
-			ind i_max = off.i + str.size();
-			for (ind i = 0; i < r; ++i) {
-				if ( s[i] == '\n' ) { lines.push_back(i_max + i + 1); }
-			}
-			// Add to stored input
-			str.insert(str.end(), s, s+r);
-			return r;
+		void evict_memo_before(ind pg) {
+			for (; memo_low < pg; ++memo_low) {
+				for (auto& col : memo_table) {
+					if ( col.cells.empty() ) continue;
+					
+					memo_cell* page = col.cells.front();
+					col.cells.pop_front();
+					if ( col.results ) memo_count.bytes -= col.results->evict();
+					if ( page == nullptr ) continue;
+					
+					for (ind j = 0; j < memo_page_size; ++j) {
+						if ( page[j] != 0 ) { ++memo_count.evictions; page[j] = 0; }
+					}
+					memo_unused.push_back(page);
+					memo_count.bytes -= memo_page_bytes;
+				}
+			}
+		}
+		
+		/** Gets the memoization table entry for a parser at an input index.
+		 *  @param id       ID of the parser
+		 *  @param i        Input index
+		 *  @return A pointer to the entry, or null if it has not been allocated
+		 */
+		memo_cell* memo_cell_at(ind id, ind i) const {
+			if ( id >= memo_table.size() ) return nullptr;
+			ind pg = i / memo_page_size;
+			if ( pg < memo_low ) return nullptr;
+			auto& pages = memo_table[id].cells;
+			if ( pg - memo_low >= pages.size() ) return nullptr;
+			memo_cell* page = pages[pg - memo_low];
+			return page ? page + i % memo_page_size : nullptr;
+		}
+		
+		/** Gets the result slot for a memoized successful match.
+		 *  @param id       ID of the parser which matched; T must be its result type
+		 *  @param i        Input index the match started at
+		 */
+		template <typename T>
+		T* memo_slot(ind id, ind i) const {
+			auto* rs = static_cast<memo_results_of<T>*>(memo_table[id].results.get());
+			memo_cell k = rs->pages[i / memo_page_size - memo_low][i % memo_page_size];
+			return &rs->values[k - 1];
+		}
+		
+		/** Number of bytes in a page of memoization table entries */
+		static const ind memo_page_bytes = memo_page_size * sizeof(memo_cell);
+		
+		/** Allocates an empty page of memoization table entries */
+		memo_cell* new_memo_page() {
+			memo_count.bytes += memo_page_bytes;
+			if ( ! memo_unused.empty() ) {
+				memo_cell* page = memo_unused.back();
+				memo_unused.pop_back();
+				return page;
+			}
+			if ( memo_blocks.empty() || memo_used == memo_block_size ) {
+				memo_blocks.emplace_back(new memo_cell[memo_block_size]());
+				memo_used = 0;
+			}
+			memo_cell* page = memo_blocks.back().get() + memo_used;
+			memo_used += memo_page_size;
+			return page;
+		}
+		
+		/** Records the beginnings of any lines starting at or before the given 
+		 *  index into the stored input; lines are only scanned for on demand, 
+		 *  with memchr() (vectorized by the C library).
+		 *  @param i		The index to scan to (should be no greater than len)
+		 */
+		void scan_lines(ind i) {
+			if ( i <= scanned ) return;
+			const value_type* b = buf + scanned;
+			const value_type* e = buf + i;
+			while ( (b = static_cast<const value_type*>(std::memchr(b, '\n', e - b))) ) {
+				++b;
+				lines.push_back(off.i + (b - buf));
+			}
+			scanned = i;
+		}
+		
+		/** Moves the furthest error position to the current position, if further, 
+		 *  discarding the errors recorded at the old position.
+		 *  @return Is the current position the furthest error position?
+		 */
+		bool furthest() {
+			if ( pos.i < fail_pos.i ) return false;
+			if ( pos.i > fail_pos.i ) {
+				fail_pos = pos;
+				notes.clear();
+				note_strs.clear();
+			}
+			return true;
+		}
+		
+		/** Records a string at the furthest error position, if not already there */
+		void add_note(const char* s, bool message) {
+			for (const note& n : notes) {
+				if ( n.s == s && n.message == message ) return;
+			}
+			notes.push_back(note{s, message});
+		}
+		
+		/** Records a copy of a string at the furthest error position, if not already 
+		 *  there */
+		void add_note(const std::string& s, bool message) {
+			for (const note& n : notes) {
+				if ( n.message == message && s == n.s ) return;
+			}
+			note_strs.push_back(s);
+			notes.push_back(note{note_strs.back().c_str(), message});
 		}
 		
 	public:
@@ -286,21 +798,131 @@ namespace parser {
 		 *  Initializes state at beginning of input stream.
 		 *  @param in		The input stream to read from
 		 */
-		state(stream_type& in) : pos(), off(), str(), lines(), memo_table(), err(), in(in) {
+		state(stream_type& in) 
+			: pos(), off(), str(), cut_len(0), buf(nullptr), len(0), lines(), scanned(0), 
+			  memo_table(), memo_blocks(), memo_used(0), memo_unused(), memo_low(0), 
+			  memo_limit(), memo_count(), fail_pos(), notes(), note_strs(), err(), 
+			  in(&in), chunk(min_read), fed(false), more(false), store() {
 			// first line starts at 0
 			lines.push_back(0);
 			// read first character
 			read();
 		}
 		
+		/** In-memory constructor.
+		 *  Initializes state at beginning of the given region, which is parsed 
+		 *  in place rather than copied; the region (e.g. a parser::mapped_file) 
+		 *  must outlive the parser state.
+		 *  @param s		The beginning of the input
+		 *  @param n		The number of characters of input
+		 */
+		state(const value_type* s, ind n) 
+			: pos(), off(), str(), cut_len(0), buf(s), len(n), lines(), scanned(0), 
+			  memo_table(), memo_blocks(), memo_used(0), memo_unused(), memo_low(0), 
+			  memo_limit(), memo_count(), fail_pos(), notes(), note_strs(), err(), 
+			  in(nullptr), chunk(min_read), fed(false), more(false), store() {
+			// first line starts at 0
+			lines.push_back(0);
+		}
+		
+		/** In-memory string constructor.
+		 *  Initializes state at beginning of the given string, which is parsed 
+		 *  in place as by state(s.data(), s.size()); the string must outlive 
+		 *  the parser state, unmodified.
+		 *  @param s		The input
+		 */
+		state(const string_type& s) : state(s.data(), s.size()) {}
+		
+		/** A temporary string would not outlive the parser state */
+		state(string_type&&) = delete;
+		
+		/** Incremental constructor.
+		 *  Initializes state at the beginning of input which is fed to it in 
+		 *  pieces by feed(), as it arrives, and ended by finish(). Until the 
+		 *  input is finished, reading past the input fed so far throws 
+		 *  incomplete_input_error rather than matching the end of input.
+		 */
+		state() 
+			: pos(), off(), str(), cut_len(0), buf(str.data()), len(0), lines(), scanned(0), 
+			  memo_table(), memo_blocks(), memo_used(0), memo_unused(), memo_low(0), 
+			  memo_limit(), memo_count(), fail_pos(), notes(), note_strs(), err(), 
+			  in(nullptr), chunk(min_read), fed(true), more(true), store() {
+			// first line starts at 0
+			lines.push_back(0);
+		}
+		
+		state(const state&) = delete;
+		state& operator = (const state&) = delete;
+		
+		/** Appends input to a state built by the incremental constructor.
+		 *  @param s		The beginning of the input to append (copied)
+		 *  @param n		The number of characters to append
+		 *  @throws std::logic_error if the state does not take more input
+		 */
+		void feed(const value_type* s, ind n) {
+			if ( ! more ) throw std::logic_error("parser::state fed after end of input");
+			
+			compact();
+			str.insert(str.end(), s, s + n);
+			// Update view of the stored input
+			buf = str.data() + cut_len;
+			len = str.size() - cut_len;
+		}
+		
+		/** Ends the input of a state built by the incremental constructor; 
+		 *  afterward, the end of the input fed is the end of the input. */
+		void finish() { more = false; }
+		
+		/** @return is the end of the input known? False only for incremental 
+		 *  states which have not been finished. */
+		bool finished() const { return ! more; }
+		
+		/** Resets the state to parse an in-memory region in place, as if newly 
+		 *  built by the in-memory constructor, but keeping the memory it has 
+		 *  allocated (and its memoization policy); positions and spans from 
+		 *  before the reset are invalidated, and values in its arena destroyed.
+		 *  @param s		The beginning of the input
+		 *  @param n		The number of characters of input
+		 */
+		void reset(const value_type* s, ind n) {
+			clear();
+			buf = s; len = n;
+			in = nullptr; fed = more = false;
+		}
+		
+		/** Resets the state to parse a string in place, as reset(s.data(), s.size()).
+		 *  @param s		The input, which must outlive its parse, unmodified
+		 */
+		void reset(const string_type& s) { reset(s.data(), s.size()); }
+		
+		/** A temporary string would not outlive its parse */
+		void reset(string_type&&) = delete;
+		
+		/** Resets the state to read from a stream, as reset(s, n).
+		 *  @param in		The input stream to read from
+		 */
+		void reset(stream_type& in) {
+			clear();
+			buf = str.data(); len = 0;
+			this->in = &in; fed = more = false;
+			read();
+		}
+		
+		/** Resets the state to take input from feed(), as reset(s, n) */
+		void reset() {
+			clear();
+			buf = str.data(); len = 0;
+			in = nullptr; fed = more = true;
+		}
+		
 		/** Reads at the cursor.
 		 *  @return The character at the current position, or '\0' for end of 
 		 *          stream.
 		 */
 		value_type operator() () const {
 			ind i = pos.i - off.i;
-			if ( i >= str.size() ) return '\0';
-			return str[i];
+			if ( i >= len ) { at_end(); return '\0'; }
+			return buf[i];
 		}
 		
 		/** Reads at the given position.
@@ -312,16 +934,34 @@ namespace parser {
 			if ( p < off ) throw forgotten_state_error(p, off);
 			
 			ind i = p.i - off.i;
-			if ( i >= str.size() ) return '\0';
-			return str[i];
+			if ( i >= len ) { at_end(); return '\0'; }
+			return buf[i];
 		}
 		
-		/** @return the current position */
+		/** Reads ahead of the cursor, reading more input as needed.
+		 *  @param n    The number of characters past the cursor to read at
+		 *  @return The character n positions past the current position, or 
+		 *          '\0' for end of stream.
+		 */
+		value_type peek(ind n) {
+			ind i = pos.i - off.i + n;
+			if ( i >= len ) {
+				read(i + 1 - len);
+				if ( i >= len ) return '\0';
+			}
+			return buf[i];
+		}
+		
+		/** @return the current position, by index only (see resolve()) */
 		struct posn posn() const { return pos; }
 		
 		/** @return the current offset in the stream */
 		struct posn offset() const { return off; }
 		
+		/** @return the arena for values built by this parse; its values live until the 
+		 *  state is reset or destroyed, unless the arena is moved out of the state */
+		parser::arena& arena() { return store; }
+		
 		/** Sets the cursor.
 		 *  @param p    The position to set (should have previously been seen)
 		 *  @throws forgotten_state_error on p < off (that is, moving to 
@@ -334,6 +974,23 @@ namespace parser {
 			pos = p;
 		}
 		
+		/** Resolves the line and column of a position, by binary search of the 
+		 *  beginnings of lines, scanning the input for them as far as needed.
+		 *  @param p    The position to resolve (should have been previously seen)
+		 *  @return p, with its line and column set
+		 *  @throws forgotten_state_error on p < off (that is, resolving a 
+		 *  		position previously discarded)
+		 */
+		struct posn resolve(const struct posn& p) {
+			// Fail on forgotten index
+			if ( p < off ) throw forgotten_state_error(p, off);
+			
+			ind i = p.i - off.i;
+			scan_lines(i < len ? i : len);
+			auto it = std::upper_bound(lines.begin(), lines.end(), p.i) - 1;
+			return {p.i, off.ln + (it - lines.begin()), p.i - *it};
+		}
+		
 		/** Advances position one step. 
 		 *  Will not advance past end-of-stream.
 		 */
@@ -341,22 +998,12 @@ namespace parser {
 			ind i = pos.i - off.i;
 			
 			// ignore if already end of stream
-			if ( i >= str.size() ) return *this;
+			if ( i >= len ) { at_end(); return *this; }
 			
-			// update index
+			// update index, reading more input if neccessary; fed input is only 
+			// required once the next character is inspected
 			++pos.i;
-			
-			// read more input if neccessary, terminating on end-of-stream
-			if ( ++i == str.size() && !read() ) { ++pos.cl; return *this; }
-			
-			// update row and column
-			ind j = pos.ln - off.ln;
-			if ( j == lines.size() - 1 || pos.i < lines[j+1] ) {
-				++pos.cl;
-			} else {
-				++pos.ln;
-				pos.cl = 0;
-			}
+			if ( ++i == len ) fill(1);
 			
 			return *this;
 		}
@@ -368,24 +1015,22 @@ namespace parser {
 			ind i = pos.i - off.i;
 			
 			// check if we need to read more input
-			if ( i + n >= str.size() ) {
+			if ( i + n >= len ) {
 				// ignore if already end of stream
-				if ( i >= str.size() ) return *this;
+				if ( i >= len ) { at_end(); return *this; }
 				
 				// read extra
-				ind nn = i + n + 1 - str.size();
-				ind r = read(nn);
+				fill(i + n + 1 - len);
 				
 				// Check read to end of stream, update n to be there
-				if ( r < nn ) n = str.size() - i;
+				if ( i + n > len ) {
+					at_end();
+					n = len - i;
+				}
 			}
 			
 			// update position
 			pos.i += n;
-			for (ind j = pos.ln - off.ln + 1; j < lines.size(); ++j) {
-				if ( pos.i >= lines[j] ) { ++pos.ln; } else break;
-			}
-			pos.cl = pos.i - lines[pos.ln - off.ln];
 			
 			return *this;
 		}
@@ -409,27 +1054,16 @@ namespace parser {
 			ind ie = ib + n;
 			
 			// Expand stored input if needed
-			if ( ie > str.size() ) {
-				ind nn = ie - str.size();
+			if ( ie > len ) {
+				ind nn = ie - len;
 				read(nn);
 			}
 			
 			// Get iterators, adjusting for the end of the input
-			iterator bIter, eIter;
+			if ( ie > len ) ie = len;
+			if ( ib > len ) ib = len;
 			
-			if ( ie >= str.size() ) {
-				eIter = str.end();
-				if ( ib >= str.size() ) {
-					bIter = str.end();
-				} else {
-					bIter = str.begin() + ib;
-				}
-			} else {
-				bIter = str.begin() + ib;
-				eIter = str.begin() + ie;
-			}
-			
-			return range_type(bIter, eIter);
+			return range_type(buf + ib, buf + ie);
 		}
 		
 		/** Substring operator.
@@ -444,66 +1078,245 @@ namespace parser {
 			return string_type(iters.first, iters.second);
 		}
 		
-		/** Gets memoization table entry at the current position.
-		 *  @param id    ID of the type to get the memoization entry for
-		 *  @param m     Output parameter for memoization entry, if found
+		/** Checks the memoization table at the current position, advancing past 
+		 *  the memoized match, if any.
+		 *  @param id       ID of the parser to get the memoization entry for
+		 *  @param success  Output parameter for whether the parser matched, if 
+		 *                  memoized
 		 *  @return Was there a memoization entry?
 		 */
-		bool memo(ind id, struct memo& m) {
-			// Get table iterator
-			ind i = pos.i - off.i;
-			if ( i >= memo_table.size() ) return false;
-			auto& tab = memo_table[i];
-			auto it = tab.find(id);
+		bool memo(ind id, bool& success) {
+			// Get table entry, breaking if nothing set
+			memo_cell* c = memo_cell_at(id, pos.i);
+			if ( c == nullptr || *c == 0 ) { ++memo_count.misses; return false; }
 			
-			// Break if nothing set
-			if ( it == tab.end() ) return false;
-			
-			// Set output parameter
-			m = it->second;
+			// Set output parameter and position
+			++memo_count.hits;
+			success = ( *c > 1 );
+			if ( success ) (*this) += (*c - 2);
+			return true;
+		}
+		
+		/** Checks the memoization table at the current position, advancing past 
+		 *  and binding the result of the memoized match, if any.
+		 *  @param id       ID of the parser to get the memoization entry for
+		 *  @param success  Output parameter for whether the parser matched, if 
+		 *                  memoized
+		 *  @param result   Output parameter for the result of the match, if 
+		 *                  memoized and successful
+		 *  @return Was there a memoization entry?
+		 */
+		template <typename T>
+		bool memo(ind id, bool& success, T& result) {
+			ind i = pos.i;
+			if ( ! memo(id, success) ) return false;
+			if ( success ) result = *memo_slot<T>(id, i);
 			return true;
 		}
 		
-		/** Sets memoization table entry.
-		 *  @param p     Position to set the memo table entry for; will silently ignore if position 
-		 *               has been forgotten
-		 *  @param id    ID of the type to set the memoization entry for
-		 *  @param m     Memoization entry to set
+		/** Checks the memoization table at the current position, advancing past 
+		 *  the memoized match, if any, and moving its result out of the table. 
+		 *  The entry is cleared, so the parser will be re-run if it is tried 
+		 *  again at this position.
+		 *  @param id       ID of the parser to get the memoization entry for
+		 *  @param success  Output parameter for whether the parser matched, if 
+		 *                  memoized
+		 *  @param result   Output parameter for the result of the match, if 
+		 *                  memoized and successful
+		 *  @return Was there a memoization entry?
+		 */
+		template <typename T>
+		bool memo_take(ind id, bool& success, T& result) {
+			ind i = pos.i;
+			if ( ! memo(id, success) ) return false;
+			if ( success ) {
+				result = std::move(*memo_slot<T>(id, i));
+				*memo_cell_at(id, i) = 0;
+			}
+			return true;
+		}
+		
+		/** Gets the result of a memoized successful match.
+		 *  @param p        Position the match started at
+		 *  @param id       ID of the parser which matched; T must be its result 
+		 *                  type
+		 *  @return A pointer to the result, or null if there is no memoized 
+		 *          successful match; invalidated by the next call to set_memo()
+		 */
+		template <typename T>
+		const T* memo_result(const struct posn& p, ind id) const {
+			if ( p < off ) return nullptr;
+			memo_cell* c = memo_cell_at(id, p.i);
+			if ( c == nullptr || *c < 2 ) return nullptr;
+			return memo_slot<T>(id, p.i);
+		}
+		
+		/** Sets memoization table entry for a match from the given position to 
+		 *  the current position.
+		 *  @param p        Position to set the memo table entry for; will silently 
+		 *                  ignore if position has been forgotten
+		 *  @param id       ID of the parser to set the memoization entry for
+		 *  @param success  Did the parser match?
 		 *  @return Was a memoization table entry set?
 		 */
-		bool set_memo(const struct posn& p, ind id, const struct memo& m) {
+		bool set_memo(const struct posn& p, ind id, bool success) {
 			// ignore forgotten position
 			if ( p < off ) return false;
 			
+			// encode entry, ignoring matches too long to store
+			ind n = success ? pos - p : 0;
+			if ( n > ind(memo_cell(-1)) - 2 ) return false;
+			
+			// apply memoization policy, ignoring evicted positions
+			ind i = p.i;
+			ind pg = i / memo_page_size;
+			if ( memo_limit.window > 0 && i >= memo_limit.window ) {
+				evict_memo_before((i - memo_limit.window) / memo_page_size);
+			}
+			if ( memo_limit.budget > 0 ) {
+				while ( memo_count.bytes > memo_limit.budget && memo_low < pg ) {
+					evict_memo_before(memo_low + 1);
+				}
+			}
+			if ( pg < memo_low ) return false;
+			
 			// ensure table initialized
-			ind i = p.i - off.i;
-			for (ind ii = memo_table.size(); ii <= i; ++ii) memo_table.emplace_back();
+			if ( id >= memo_table.size() ) memo_table.resize(id + 1);
+			auto& pages = memo_table[id].cells;
+			ind k = pg - memo_low;
+			// (grown at the back, as resizing an empty deque grows it at the front)
+			while ( k >= pages.size() ) pages.push_back(nullptr);
+			if ( pages[k] == nullptr ) pages[k] = new_memo_page();
 			
 			// set table entry
-			memo_table[i][id] = m;
+			pages[k][i % memo_page_size] = success ? memo_cell(n + 2) : 1;
+			return true;
+		}
+		
+		/** Sets memoization table entry for a match from the given position to 
+		 *  the current position, with a result.
+		 *  @param p        Position to set the memo table entry for; will silently 
+		 *                  ignore if position has been forgotten
+		 *  @param id       ID of the parser to set the memoization entry for
+		 *  @param success  Did the parser match?
+		 *  @param result   The result of the match, if successful; copied into 
+		 *                  the table, or moved if passed as an rvalue
+		 *  @return Was a memoization table entry set?
+		 */
+		template <typename U>
+		bool set_memo(const struct posn& p, ind id, bool success, U&& result) {
+			typedef typename std::decay<U>::type T;
+			if ( ! set_memo(p, id, success) ) return false;
+			if ( ! success ) return true;
+			
+			// store result
+			auto& rs = memo_table[id].results;
+			if ( ! rs ) rs.reset(new memo_results_of<T>());
+			auto& r = *static_cast<memo_results_of<T>*>(rs.get());
+			memo_count.bytes += r.set(p.i / memo_page_size - memo_low, p.i % memo_page_size, 
+			                          std::forward<U>(result));
 			return true;
 		}
 		
-		/** Get the parser's internal error object */
-		const struct error& error() const { return err; }
+		/** Get the limits on memory used by the memoization table */
+		const struct memo_policy& memo_policy() const { return memo_limit; }
+		
+		/** Sets the limits on memory used by the memoization table; entries 
+		 *  which are evicted to stay within the limits will be recomputed if 
+		 *  needed. */
+		void set_memo_policy(const struct memo_policy& p) { memo_limit = p; }
+		
+		/** Get the memoization table usage counters */
+		const struct memo_stats& memo_stats() const { return memo_count; }
+		
+		/** Binds the input between the given position and the current 
+		 *  position to a string.
+		 *  @param p		The beginning of the capture
+		 *  @param s		The string to bind
+		 */
+		void capture(const struct posn& p, std::string& s) {
+			s = string(p, pos - p);
+		}
+		
+		/** Binds the input between the given position and the current 
+		 *  position to a span, without copying it.
+		 *  @param p		The beginning of the capture
+		 *  @param s		The span to bind
+		 *  @throws forgotten_state_error on p < off
+		 */
+		void capture(const struct posn& p, span& s) {
+			if ( p < off ) throw forgotten_state_error(p, off);
+			s = span(this, p.i, pos - p);
+		}
+		
+		/** Discards all stored input, line, and memoization state before the 
+		 *  current position. Afterward, any attempt to return to an earlier 
+		 *  position will throw forgotten_state_error, and spans captured 
+		 *  before the current position are invalidated.
+		 */
+		void cut() {
+			ind n = pos.i - off.i;
+			if ( n == 0 ) return;
+			
+			// Resolve positions before their lines are discarded
+			if ( fail_pos >= off && fail_pos < pos ) fail_pos = resolve(fail_pos);
+			struct posn p = resolve(pos);
+			
+			// Discard beginnings of lines before the current line
+			lines.erase(lines.begin(), lines.begin() + (p.ln - off.ln));
+			
+			// Discard input
+			if ( in || fed ) cut_len += n;
+			buf += n;
+			len -= n;
+			scanned -= n;
+			off = p;
+			
+			// Discard memoization entries
+			evict_memo_before(pos.i / memo_page_size);
+		}
+		
+		/** Get the parser's error object, built from the errors recorded at the 
+		 *  furthest position, with that position resolved */
+		const struct error& error() {
+			if ( fail_pos >= off ) fail_pos = resolve(fail_pos);
+			err = parser::error(fail_pos);
+			for (const note& n : notes) {
+				if ( n.message ) { err.message(n.s); } else { err.expect(n.s); }
+			}
+			return err;
+		}
+		
+		/** Adds an "expected" message at the current position.
+		 *  @param s        The message, which must outlive the parser state (e.g. a 
+		 *                  string literal, or from parser::intern()); it is recorded 
+		 *                  by pointer. If null, adds an unexplained error.
+		 */
+		void expect(const char* s) {
+			if ( furthest() && s ) add_note(s, false);
+		}
 		
 		/** Adds an "expected" message at the current position */
 		void expect(const std::string& s) {
-			struct error e; e.pos = pos; e.expect(s);
-			err |= e;
+			if ( furthest() ) add_note(s, false);
+		}
+		
+		/** Adds a programmer-defined error message at the current position.
+		 *  @param s        The message, which must outlive the parser state (e.g. a 
+		 *                  string literal, or from parser::intern()); it is recorded 
+		 *                  by pointer. If null, adds an unexplained error.
+		 */
+		void message(const char* s) {
+			if ( furthest() && s ) add_note(s, true);
 		}
 		
 		/** Adds a programmer-defined error message at the current position */
 		void message(const std::string& s) {
-			struct error e; e.pos = pos; e.message(s);
-			err |= e;
+			if ( furthest() ) add_note(s, true);
 		}
 		
 		/** Adds an unexplained error at the current position */
-		void fail() {
-			struct error e; e.pos = pos;
-			err |= e;
-		}
+		void fail() { furthest(); }
 		
 		/** Attempts to match a character at the current position */
 		bool matches(value_type c) {
@@ -514,8 +1327,30 @@ namespace parser {
 		
 		/** Attempts to match a string at the current position */
 		bool matches(const string_type& s) {
-			if ( string(pos, s.size()) != s ) return false;
-			(*this) += s.size();
+			return matches(s.data(), s.size());
+		}
+		
+		/** Attempts to match a string of known length at the current position.
+		 *  @param s        The characters to match
+		 *  @param n        The number of characters in s
+		 */
+		bool matches(const value_type* s, ind n) {
+			ind i = pos.i - off.i;
+			
+			// Expand stored input if needed
+			if ( i + n > len ) {
+				fill(i + n - len);
+				if ( i + n > len ) {
+					// fail on a mismatch in the stored input before asking for more
+					ind m = ( i < len ) ? len - i : 0;
+					if ( std::memcmp(buf + i, s, m) != 0 ) return false;
+					at_end();
+					return false;
+				}
+			}
+			
+			if ( std::memcmp(buf + i, s, n) != 0 ) return false;
+			(*this) += n;
 			return true;
 		}
 		
@@ -562,23 +1397,340 @@ namespace parser {
 			++(*this);
 			return true;
 		}
+		
+		/** Attempts to match a character in the given set at the current 
+		 *  position.
+		 *  @param cs       The set of characters to match
+		 *  @param psVal    The character matched, if any
+		 */
+		bool matches_in(const charset& cs, value_type& psVal) {
+			value_type c = (*this)();
+			if ( ! cs(c) ) return false;
+			psVal = c;
+			++(*this);
+			return true;
+		}
+		
+		/** Attempts to match a character in the given set at the current 
+		 *  position.
+		 *  @param cs       The set of characters to match
+		 */
+		bool matches_in(const charset& cs) {
+			if ( ! cs((*this)()) ) return false;
+			++(*this);
+			return true;
+		}
+		
+		/** Advances past the run of characters in the given set at the current 
+		 *  position, reading more input as needed, and advancing the position 
+		 *  index once for the whole run.
+		 *  @param s        The set of characters to skip
+		 *  @param keep     The number of characters at the end of the run to 
+		 *                  leave unconsumed
+		 */
+		void skip(const scan_set& s, ind keep = 0) {
+			ind i = pos.i - off.i;
+			if ( i >= len ) { at_end(); return; }
+			
+			ind j = i;
+			do {
+				// buf may move on read, so resume by index
+				j = parser::scan(s, buf + j, buf + len) - buf;
+			} while ( j == len && read() );
+			
+			if ( j - i > keep ) *this += j - i - keep;
+		}
+		
+		/** Attempts to match a lexical rule compiled to an automaton at the current
+		 *  position, reporting the same errors as the rule; the automaton runs over the
+		 *  stored input by index, and the position is only updated once it is done.
+		 *  @param a        The automaton to run
+		 */
+		bool matches(const dfa& a) {
+			ind start = pos.i - off.i, i = start;
+			ind regs[dfa::max_regs], next[dfa::max_regs];
+			ind rec = start, end = start;  // furthest error and end of match
+			std::uint32_t mask = 0;        // errors at rec
+			bool matched = false;
+			ind run = start;               // end of a run whose last transition is left
+			
+			const dfa_edge* e = a.edges;
+			while ( true ) {
+				if ( e->begin != e->end ) {
+					bool moved = false;
+					for (const dfa_op* o = a.ops + e->begin; o != a.ops + e->end; ++o) {
+						ind p = 0;
+						switch ( o->op ) {
+						case dfa::record_at:  p = i - o->a;     break;
+						case dfa::record_reg: p = regs[o->a];   break;
+						case dfa::set_reg:    next[o->a] = i - o->b;    moved = true; continue;
+						case dfa::copy_reg:   next[o->a] = regs[o->b];  moved = true; continue;
+						case dfa::match_at:   end = i - o->a;   matched = true; continue;
+						case dfa::match_reg:  end = regs[o->a]; matched = true; continue;
+						}
+						// keep furthest errors, merging those at the same position
+						if ( mask == 0 || p > rec ) { rec = p; mask = o->b; }
+						else if ( p == rec ) { mask |= o->b; }
+					}
+					if ( moved ) std::copy(next, next + dfa::max_regs, regs);
+				}
+				if ( run > i ) { i = run; continue; }
+				if ( e->to == dfa::stop ) break;
+				
+				// skip a run, taking its transition for only the last two characters
+				if ( a.runs != nullptr && a.runs[e->to] != 0 ) {
+					ind j = i;
+					do {
+						// buf may move on read, so resume by index
+						j = parser::scan(a.run_sets[a.runs[e->to]-1], buf + j, buf + len) - buf;
+					} while ( j == len && read() );
+					
+					if ( j > i ) {
+						unsigned char c = buf[i];
+						e = a.edges + a.trans[e->to * a.n_classes + a.classes[c]];
+						if ( j - i > 1 ) { run = j; i = j - 1; } else { i = j; }
+						continue;
+					}
+				}
+				
+				// read next character; buf may move on read, but indices are stable
+				if ( i == len ) read();
+				unsigned char c = ( i < len ) ? buf[i] : '\0';
+				e = a.edges + a.trans[e->to * a.n_classes + a.classes[c]];
+				++i;
+			}
+			
+			// report errors, then move to the end of the match (or stay at the start)
+			if ( ! matched ) end = start;
+			if ( mask != 0 ) {
+				struct posn psStart = pos;
+				if ( rec > start ) *this += rec - start;
+				if ( mask & 1 ) fail();
+				for (unsigned k = 1; k < 32; ++k) {
+					if ( mask & (1u << k) ) expect(a.expected[k-1]);
+				}
+				if ( rec == end ) return matched;
+				pos = psStart;
+			}
+			if ( end > start ) *this += end - start;
+			return matched;
+		}
 	private:
 		/** Current parsing location */
 		struct posn pos;
-		/** Offset of start of str from the beginning of the stream */
+		/** Offset of start of buf from the beginning of the stream */
 		struct posn off;
-		/** Characters currently in use by the parser */
-		std::deque<value_type> str;
-		/** Beginning indices of each line, starting from off.line */
+		/** Characters read from the input stream, stored contiguously */
+		std::vector<value_type> str;
+		/** Number of characters at the start of str discarded by cut() */
+		ind cut_len;
+		/** Characters currently in use by the parser; either str or an 
+		 *  externally-owned in-memory region */
+		const value_type* buf;
+		/** Number of characters in buf */
+		ind len;
+		/** Beginning indices of each line, starting from off.line(); scanned 
+		 *  for only as far as positions have been resolved */
 		std::deque<ind> lines;
-		/** Memoization tables for each stored input index */
-		std::deque<std::unordered_map<ind, struct memo>> memo_table;
-		/** Set of most recent parsing errors */
+		/** Index into buf up to which line beginnings have been recorded */
+		ind scanned;
+		/** Base class for typed memoization results; the type of the results 
+		 *  for each memoization ID is fixed by the generated parser */
+		struct memo_results {
+			virtual ~memo_results() {}
+			
+			/** Discards the results for the first remaining page of input indices.
+			 *  @return The number of bytes freed */
+			virtual ind evict() = 0;
+			
+			/** Discards all results, keeping their memory for reuse */
+			virtual void clear() = 0;
+		};
+		/** Results of a single typed parser's successful matches */
+		template <typename T>
+		struct memo_results_of : public memo_results {
+			/** Stores a result, copied or moved as passed.
+			 *  @param pg       Page of the result, relative to the first remaining page
+			 *  @param j        Index of the result in its page
+			 *  @return The number of bytes allocated */
+			template <typename U>
+			ind set(ind pg, ind j, U&& result) {
+				ind bytes = 0;
+				while ( pg >= pages.size() ) pages.emplace_back();
+				if ( ! pages[pg] ) {
+					if ( spare.empty() ) {
+						pages[pg].reset(new memo_cell[memo_page_size]());
+					} else {
+						pages[pg] = std::move(spare.back());
+						spare.pop_back();
+					}
+					bytes += memo_page_bytes;
+				}
+				
+				memo_cell& k = pages[pg][j];
+				if ( k != 0 ) {
+					values[k-1] = std::forward<U>(result);
+				} else if ( ! unused.empty() ) {
+					k = unused.back() + 1;
+					unused.pop_back();
+					values[k-1] = std::forward<U>(result);
+				} else {
+					values.push_back(std::forward<U>(result));
+					k = values.size();
+					bytes += sizeof(T);
+				}
+				return bytes;
+			}
+			
+			ind evict() {
+				if ( pages.empty() ) return 0;
+				std::unique_ptr<memo_cell[]> page = std::move(pages.front());
+				pages.pop_front();
+				if ( ! page ) return 0;
+				
+				for (ind j = 0; j < memo_page_size; ++j) {
+					memo_cell k = page[j];
+					if ( k == 0 ) continue;
+					page[j] = 0;
+					values[k-1] = T();
+					unused.push_back(k-1);
+				}
+				spare.push_back(std::move(page));
+				return memo_page_bytes;
+			}
+			
+			void clear() {
+				for (auto& page : pages) {
+					if ( ! page ) continue;
+					std::fill(page.get(), page.get() + memo_page_size, memo_cell(0));
+					spare.push_back(std::move(page));
+				}
+				pages.clear();
+				values.clear();
+				unused.clear();
+			}
+			
+			/** Pages parallel to memo_column::cells, holding 1 plus the index of 
+			 *  each result in values, or 0 for none */
+			std::deque<std::unique_ptr<memo_cell[]>> pages;
+			/** Results, stored contiguously */
+			std::vector<T> values;
+			/** Indices into values of evicted results, for reuse */
+			std::vector<memo_cell> unused;
+			/** Evicted pages, cleared for reuse */
+			std::vector<std::unique_ptr<memo_cell[]>> spare;
+		};
+		/** Memoization entries for a single parser, indexed by input index */
+		struct memo_column {
+			/** Pages of packed match outcomes, starting from page memo_low; null 
+			 *  for pages with no entries */
+			std::deque<memo_cell*> cells;
+			/** Results of successful typed matches; null for untyped parsers */
+			std::unique_ptr<memo_results> results;
+		};
+		/** Memoization tables, indexed by parser memoization ID */
+		std::vector<memo_column> memo_table;
+		/** Storage for the pages of memo_table */
+		std::vector<std::unique_ptr<memo_cell[]>> memo_blocks;
+		/** Number of entries allocated from the last of memo_blocks */
+		ind memo_used;
+		/** Evicted pages of memo_table, for reuse */
+		std::vector<memo_cell*> memo_unused;
+		/** Lowest page of input indices which has not been evicted */
+		ind memo_low;
+		/** Limits on the memory used by memo_table */
+		struct memo_policy memo_limit;
+		/** Memoization table usage counters */
+		struct memo_stats memo_count;
+		/** An "expected" string or error message recorded at fail_pos */
+		struct note {
+			const char* s;  ///< The string (not owned)
+			bool message;   ///< Is this an error message, rather than an expected string?
+		};
+		/** Furthest position an error has been recorded at */
+		struct posn fail_pos;
+		/** Strings recorded at fail_pos, in order */
+		std::vector<note> notes;
+		/** Copies of strings in notes which were not given with static lifetimes */
+		std::deque<std::string> note_strs;
+		/** Errors at fail_pos, built on request by error() */
 		struct error err;
-		/** Input stream to read characters from */
-		stream_type& in;
+		/** Input stream to read characters from (null for in-memory input) */
+		stream_type* in;
+		/** Number of characters to request on the next read */
+		ind chunk;
+		/** Is input fed to the state by feed(), rather than read? */
+		bool fed;
+		/** May more input yet be fed to the state? */
+		bool more;
+		/** Values built by the parse */
+		parser::arena store;
 	}; /* class state */
 	
+	const span::value_type* span::data() const {
+		return ps ? ps->buf + (i - ps->off.index()) : nullptr;
+	}
+	
+	/** Pool of parser states, which keeps the memory of states returned to it for 
+	 *  reuse, so that parsing many small inputs allocates little once the pool is warm. 
+	 *  A pool and the states taken from it should only be used by one thread; states 
+	 *  must be returned before their pool is destroyed. */
+	class state_pool {
+	public:
+		/** Returns a state to the pool it was taken from */
+		struct release {
+			void operator() (state* ps) const { pool->free.emplace_back(ps); }
+			state_pool* pool;
+		};
+		/** A state taken from a pool, returned to it when destroyed */
+		typedef std::unique_ptr<state, release> pointer;
+		
+		/** @return the pool for the current thread */
+		static state_pool& local() {
+			static thread_local state_pool pool;
+			return pool;
+		}
+		
+		/** @return a state parsing an in-memory region in place, as state(s, n) */
+		pointer take(const state::value_type* s, ind n) {
+			pointer ps = acquire();
+			ps->reset(s, n);
+			return ps;
+		}
+		
+		/** @return a state parsing a string in place, as state(s) */
+		pointer take(const state::string_type& s) { return take(s.data(), s.size()); }
+		
+		/** A temporary string would not outlive its parse */
+		pointer take(state::string_type&&) = delete;
+		
+		/** @return a state reading from a stream, as state(in) */
+		pointer take(state::stream_type& in) {
+			pointer ps = acquire();
+			ps->reset(in);
+			return ps;
+		}
+		
+		/** @return a state taking input from state::feed(), as state() */
+		pointer take() {
+			pointer ps = acquire();
+			ps->reset();
+			return ps;
+		}
+		
+	private:
+		/** @return a pooled state, or a new one if there are none */
+		pointer acquire() {
+			if ( free.empty() ) return pointer(new state(), release{this});
+			pointer ps(free.back().release(), release{this});
+			free.pop_back();
+			return ps;
+		}
+		
+		/** States returned to the pool */
+		std::vector<std::unique_ptr<state>> free;
+	}; /* class state_pool */
+	
 	/** Parser combinator type */
 	using combinator = std::function<bool(state&)>;
 	/** List of parser combinators */
@@ -587,6 +1739,37 @@ namespace parser {
 	template <typename T>
 	using nonterminal = bool (*)(state&,T&);
 	
+	/** Holds a rule-local variable for the duration of a rule invocation.
+	 *  Generated rules build their combinators once, bound to per-rule variables; each 
+	 *  invocation swaps out the value left in such a variable by any enclosing (recursive) 
+	 *  invocation on entry, and swaps it back in on exit. */
+	template <typename T>
+	class frame_slot {
+	public:
+		/** Saves the current value of v, leaving it default-constructed */
+		frame_slot(T& v) : v(v), out(nullptr), saved() { std::swap(v, saved); }
+		
+		/** Saves the current value of v, replacing it with the value of out; out will be 
+		 *  given the final value of v on exit */
+		frame_slot(T& v, T& out) : v(v), out(&out), saved() {
+			std::swap(v, saved);
+			std::swap(v, out);
+		}
+		
+		~frame_slot() {
+			if ( out ) std::swap(v, *out);
+			std::swap(v, saved);
+		}
+		
+	private:
+		frame_slot(const frame_slot&);             // not copyable
+		frame_slot& operator= (const frame_slot&); // not assignable
+		
+		T& v;     ///< The variable held
+		T* out;   ///< Output parameter for the final value of v (null for none)
+		T saved;  ///< The value of v before this invocation
+	}; /* class frame_slot */
+	
 	/** Character literal parser */
 	combinator literal(state::value_type c) {
 //		return [c](state& ps) { return ps.matches(c); };
@@ -613,8 +1796,8 @@ namespace parser {
 	
 	/** String literal parser */
 	combinator literal(const state::string_type& s) {
-//		return [&s](state& ps) { return ps.matches(s); };
-		return [&s](state& ps) {
+//		return [s](state& ps) { return ps.matches(s); };
+		return [s](state& ps) {
 			if ( ps.matches(s) ) { return true; }
 			
 			ps.fail();
@@ -669,11 +1852,64 @@ namespace parser {
 		};
 	}
 	
+	/** Character set parser */
+	combinator in_set(const charset& cs) {
+		return [cs](state& ps) {
+			if ( ps.matches_in(cs) ) { return true; }
+			
+			ps.fail();
+			return false;
+		};
+	}
+	
+	/** Character set parser
+	 *  @param psVal    Will be bound to the character matched
+	 */
+	combinator in_set(const charset& cs, state::value_type& psVal) {
+		return [cs,&psVal](state& ps) {
+			if ( ps.matches_in(cs, psVal) ) { return true; }
+			
+			ps.fail();
+			return false;
+		};
+	}
+	
+	/** Matches a parser any number of times, first skipping the run of characters in a set 
+	 *  that the repetitions are known to match all of, less the last keep characters
+	 *  @param s        The characters each repetition matches exactly one of
+	 *  @param keep     The number of characters at the end of the run to leave to the parser
+	 */
+	combinator many_in(const scan_set& s, ind keep, const combinator& f) {
+		return [s,keep,f](state& ps) {
+			ps.skip(s, keep);
+			while ( f(ps) )
+				;
+			return true;
+		};
+	}
+	
+	/** Matches a parser some positive number of times, first skipping the run of characters 
+	 *  in a set that the repetitions are known to match all of, less the last keep characters
+	 *  @param s        The characters each repetition matches exactly one of
+	 *  @param keep     The number of characters at the end of the run to leave to the parser
+	 */
+	combinator some_in(const scan_set& s, ind keep, const combinator& f) {
+		return [s,keep,f](state& ps) {
+			posn psStart = ps.posn();
+			ps.skip(s, keep);
+			if ( ps.posn() == psStart && ! f(ps) ) return false;
+			while ( f(ps) )
+				;
+			return true;
+		};
+	}
+	
 	/** Matches all or none of a sequence of parsers */
 	combinator sequence(combinator_list fs) {
-		return [fs](state& ps) {
+		std::vector<combinator> gs(fs);
+		return [gs](state& ps) {
 			posn psStart = ps.posn();
-			for (auto f : fs) {
+			for (auto& f : gs) {
 				if ( ! f(ps) ) { ps.set_posn(psStart); return false; }
 			}
 			return true;
@@ -682,8 +1918,9 @@ namespace parser {
 	
 	/** Matches one of a set of alternate parsers */
 	combinator choice(combinator_list fs) {
-		return [fs](state& ps) {
-			for (auto f : fs) {
+		std::vector<combinator> gs(fs);
+		return [gs](state& ps) {
+			for (auto& f : gs) {
 				if ( f(ps) ) return true;
 			}
 			return false;
@@ -692,7 +1929,7 @@ namespace parser {
 	
 	/** Matches a parser any number of times */
 	combinator many(const combinator& f) {
-		return [&f](state& ps) {
+		return [f](state& ps) {
 			while ( f(ps) )
 				;
 			return true;
@@ -701,7 +1938,7 @@ namespace parser {
 	
 	/** Matches a parser some positive number of times */
 	combinator some(const combinator& f) {
-		return [&f](state& ps) {
+		return [f](state& ps) {
 			if ( ! f(ps) ) return false;
 			while ( f(ps) )
 				;
@@ -711,7 +1948,7 @@ namespace parser {
 	
 	/** Optionally matches a parser */
 	combinator option(const combinator& f) {
-		return [&f](state& ps) {
+		return [f](state& ps) {
 			f(ps);
 			return true;
 		};
@@ -719,7 +1956,7 @@ namespace parser {
 	
 	/** Looks ahead to match a parser without consuming input */
 	combinator look(const combinator& f) {
-		return [&f](state& ps) {
+		return [f](state& ps) {
 			posn psStart = ps.posn();
 			if ( f(ps) ) { ps.set_posn(psStart); return true; }
 			return false;
@@ -728,7 +1965,7 @@ namespace parser {
 	
 	/** Looks ahead to not match a parser without consuming input */
 	combinator look_not(const combinator& f) {
-		return [&f](state& ps) {
+		return [f](state& ps) {
 			posn psStart = ps.posn();
 			if ( f(ps) ) { ps.set_posn(psStart); return false; }
 			return true;
@@ -749,17 +1986,14 @@ namespace parser {
 	
 	/** Memoizes a combinator with the given memoization ID */
 	combinator memoize(ind id, const combinator& f) {
-		return [id,&f](state& ps) {
-			memo m;
-			if ( ps.memo(id, m) ) {
-				if ( m.success ) ps.set_posn(m.end);
-			} else {
+		return [id,f](state& ps) {
+			bool success;
+			if ( ! ps.memo(id, success) ) {
 				posn psStart = ps.posn();
-				m.success = f(ps);
-				m.end = ps.posn();
-				ps.set_memo(psStart, id, m);
+				success = f(ps);
+				ps.set_memo(psStart, id, success);
 			}
-			return m.success;
+			return success;
 		};
 	}
 	
@@ -767,45 +2001,49 @@ namespace parser {
 	template <typename T>
 	combinator memoize(ind id, T& psVal, const combinator& f) {
 		return [id,&psVal,f](state& ps) {
-			memo m;
-			if ( ps.memo(id, m) ) {
-				if ( m.success ) {
-					m.result.bind(psVal);
-					ps.set_posn(m.end);
-				}
-			} else {
+			bool success;
+			if ( ! ps.memo(id, success, psVal) ) {
+				posn psStart = ps.posn();
+				success = f(ps);
+				ps.set_memo(psStart, id, success, psVal);
+			}
+			return success;
+		};
+	}
+	
+	/** Memoizes and binds a combinator with the given memoization ID, moving its result 
+	 *  out of the memoization table when it is reused rather than copying it; for parsers 
+	 *  whose memoized results are reused at most once (they are recomputed if tried again) */
+	template <typename T>
+	combinator memoize_once(ind id, T& psVal, const combinator& f) {
+		return [id,&psVal,f](state& ps) {
+			bool success;
+			if ( ! ps.memo_take(id, success, psVal) ) {
 				posn psStart = ps.posn();
-				m.success = f(ps);
-				m.end = ps.posn();
-				if ( m.success ) m.result = psVal;
-				ps.set_memo(psStart, id, m);
+				success = f(ps);
+				ps.set_memo(psStart, id, success, psVal);
 			}
-			return m.success;
+			return success;
 		};
 	}
 	
 	namespace {
 		/** Helper function for memoizing repetition */
-		memo many_memoized(ind id, const combinator& f, state& ps) {
-			memo m;
-			if ( ps.memo(id, m) ) {
-				if ( m.end > ps.posn() ) ps.set_posn(m.end);
-			} else {
+		void many_memoized(ind id, const combinator& f, state& ps) {
+			bool success;
+			if ( ! ps.memo(id, success) ) {
 				posn psStart = ps.posn();
 				if ( f(ps) ) {
-					m = many_memoized(id, f, ps);
+					many_memoized(id, f, ps);
 				}
-				m.success = true;
-				m.end = ps.posn();
-				ps.set_memo(psStart, id, m);
+				ps.set_memo(psStart, id, true);
 			}
-			return m;
 		}
 	} /* anonymous namespace */
 	
 	/** Memoizes a many-matcher  */
 	combinator memoize_many(ind id, const combinator& f) {
-		return [id,&f](state& ps) {
+		return [id,f](state& ps) {
 			many_memoized(id, f, ps);
 			return true;
 		};
@@ -813,19 +2051,20 @@ namespace parser {
 	
 	/** Memoizes a some-matcher */
 	combinator memoize_some(ind id, const combinator& f) {
-		return [id,&f](state& ps) {
+		return [id,f](state& ps) {
 			posn psStart = ps.posn();
 			many_memoized(id, f, ps);
 			return ( ps.posn() > psStart );
 		};
 	}
 	
-	/** Captures a string */
-	combinator capture(std::string& s, const combinator& f) {
-		return [&s,&f](state& ps) {
+	/** Captures a string (or span, for S = parser::span) */
+	template <typename S>
+	combinator capture(S& s, const combinator& f) {
+		return [&s,f](state& ps) {
 			posn psStart = ps.posn();
 			if ( ! f(ps) ) return false;
-			s = ps.string(psStart, ps.posn() - psStart);
+			ps.capture(psStart, s);
 			return true;
 		};
 	}
@@ -835,17 +2074,49 @@ namespace parser {
 		return [](state&) { return true; };
 	}
 	
+	/** Failure parser; inserts message, or an unexplained error if null */
+	combinator fail(const char* s) {
+		const char* m = s ? intern(s) : nullptr;
+		return [m](state& ps) { ps.message(m); return false; };
+	}
+	
 	/** Failure parser; inserts message */
-	combinator fail(const std::string& s) {
-		return [&s](state& ps) { ps.message(s); return false; };
+	combinator fail(const std::string& s) { return fail(s.c_str()); }
+	
+	/** Cut parser; always matches, discarding parser state before the current position */
+	combinator cut() {
+		return [](state& ps) { ps.cut(); return true; };
 	}
 	
-	/** Names a parser for better error messages */
-	combinator named(const std::string& s, const combinator& f) {
-		return [&s,&f](state& ps) {
+	/** Names a parser for better error messages; a null name reports an unexplained error 
+	 *  in place of the parser's own */
+	combinator named(const char* s, const combinator& f) {
+		const char* n = s ? intern(s) : nullptr;
+		return [n,f](state& ps) {
 			if ( f(ps) ) return true;
 			
-			ps.expect(s);
+			ps.expect(n);
+			return false;
+		};
+	}
+	
+	/** Names a parser for better error messages */
+	combinator named(const std::string& s, const combinator& f) { return named(s.c_str(), f); }
+	
+	/** Guards a parser by the set of characters it can start with; fails without running 
+	 *  the parser if the current character is not in that set, reporting the given 
+	 *  "expected" errors in its place */
+	template <typename... Es>
+	combinator guard(const charset& cs, const combinator& f, Es... es) {
+		std::vector<const char*> ns;
+		for (const std::string& s : std::initializer_list<std::string>{es...}) {
+			ns.push_back(intern(s));
+		}
+		return [cs,f,ns](state& ps) {
+			if ( cs(ps()) ) return f(ps);
+			
+			if ( ns.empty() ) { ps.fail(); }
+			for (const char* n : ns) { ps.expect(n); }
 			return false;
 		};
 	}
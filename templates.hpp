@@ -0,0 +1,671 @@
+#pragma once
+
+/*
+ * Copyright (c) 2013 Aaron Moss
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <array>
+#include <string>
+
+#include "parser.hpp"
+
+/** Implements statically-typed parser combinators for an Egg parser.
+ *  
+ *  These combinators parallel the std::function-based combinators in parser.hpp, but each 
+ *  combinator is a distinct type composed at compile time, so a rule built from them can be 
+ *  fully inlined into straight-line code. Combinators hold references to the variables they 
+ *  bind, and so should be built for each rule invocation, which costs no allocation. Any 
+ *  callable object with signature bool(parser::state&) (including rule functions and 
+ *  lambdas) may be used as a combinator.
+ *  
+ *  @author Aaron Moss
+ */
+
+namespace parser {
+namespace tmpl {
+	
+	/** Character literal parser */
+	struct char_literal {
+		char_literal(state::value_type c) : c(c) {}
+		
+		bool operator() (state& ps) const {
+			if ( ps.matches(c) ) { return true; }
+			
+			ps.fail();
+			return false;
+		}
+		
+		state::value_type c;  ///< Character to match
+	}; /* struct char_literal */
+	
+	/** Bound character literal parser */
+	struct char_literal_bound {
+		char_literal_bound(state::value_type c, state::value_type& psVal) : c(c), psVal(psVal) {}
+		
+		bool operator() (state& ps) const {
+			if ( ps.matches(c) ) { psVal = c; return true; }
+			
+			ps.fail();
+			return false;
+		}
+		
+		state::value_type c;       ///< Character to match
+		state::value_type& psVal;  ///< Bound variable
+	}; /* struct char_literal_bound */
+	
+	/** String literal parser */
+	struct str_literal {
+		str_literal(const state::value_type* s, ind n) : s(s), n(n) {}
+		
+		bool operator() (state& ps) const {
+			if ( ps.matches(s, n) ) { return true; }
+			
+			ps.fail();
+			return false;
+		}
+		
+		const state::value_type* s;  ///< String to match (not owned)
+		ind n;                       ///< Length of s
+	}; /* struct str_literal */
+	
+	/** Any character parser */
+	struct any_char {
+		bool operator() (state& ps) const {
+			if ( ps.matches_any() ) { return true; }
+			
+			ps.fail();
+			return false;
+		}
+	}; /* struct any_char */
+	
+	/** Bound any character parser */
+	struct any_char_bound {
+		any_char_bound(state::value_type& psVal) : psVal(psVal) {}
+		
+		bool operator() (state& ps) const {
+			if ( ps.matches_any(psVal) ) { return true; }
+			
+			ps.fail();
+			return false;
+		}
+		
+		state::value_type& psVal;  ///< Bound variable
+	}; /* struct any_char_bound */
+	
+	/** Character range parser */
+	struct char_range {
+		char_range(state::value_type s, state::value_type e) : s(s), e(e) {}
+		
+		bool operator() (state& ps) const {
+			if ( ps.matches_in(s, e) ) { return true; }
+			
+			ps.fail();
+			return false;
+		}
+		
+		state::value_type s;  ///< First character in range
+		state::value_type e;  ///< Last character in range
+	}; /* struct char_range */
+	
+	/** Bound character range parser */
+	struct char_range_bound {
+		char_range_bound(state::value_type s, state::value_type e, state::value_type& psVal) 
+			: s(s), e(e), psVal(psVal) {}
+		
+		bool operator() (state& ps) const {
+			if ( ps.matches_in(s, e, psVal) ) { return true; }
+			
+			ps.fail();
+			return false;
+		}
+		
+		state::value_type s;       ///< First character in range
+		state::value_type e;       ///< Last character in range
+		state::value_type& psVal;  ///< Bound variable
+	}; /* struct char_range_bound */
+	
+	/** Character set parser */
+	struct char_set {
+		char_set(const charset& cs) : cs(cs) {}
+		
+		bool operator() (state& ps) const {
+			if ( ps.matches_in(cs) ) { return true; }
+			
+			ps.fail();
+			return false;
+		}
+		
+		charset cs;  ///< Characters to match
+	}; /* struct char_set */
+	
+	/** Bound character set parser */
+	struct char_set_bound {
+		char_set_bound(const charset& cs, state::value_type& psVal) : cs(cs), psVal(psVal) {}
+		
+		bool operator() (state& ps) const {
+			if ( ps.matches_in(cs, psVal) ) { return true; }
+			
+			ps.fail();
+			return false;
+		}
+		
+		charset cs;                ///< Characters to match
+		state::value_type& psVal;  ///< Bound variable
+	}; /* struct char_set_bound */
+	
+	/** Matches all of a list of parsers, without resetting on failure */
+	template <typename... Fs>
+	struct all_of;
+	
+	template <>
+	struct all_of<> {
+		bool operator() (state&) const { return true; }
+	};
+	
+	template <typename F, typename... Fs>
+	struct all_of<F, Fs...> {
+		all_of(F f, Fs... fs) : f(f), fs(fs...) {}
+		
+		bool operator() (state& ps) const { return f(ps) && fs(ps); }
+		
+		F f;             ///< First parser
+		all_of<Fs...> fs;  ///< Remaining parsers
+	};
+	
+	/** Matches one of a list of alternate parsers */
+	template <typename... Fs>
+	struct one_of;
+	
+	template <>
+	struct one_of<> {
+		bool operator() (state&) const { return false; }
+	};
+	
+	template <typename F, typename... Fs>
+	struct one_of<F, Fs...> {
+		one_of(F f, Fs... fs) : f(f), fs(fs...) {}
+		
+		bool operator() (state& ps) const { return f(ps) || fs(ps); }
+		
+		F f;               ///< First alternative
+		one_of<Fs...> fs;  ///< Remaining alternatives
+	};
+	
+	/** Matches all or none of a sequence of parsers */
+	template <typename... Fs>
+	struct sequence_of {
+		sequence_of(Fs... fs) : fs(fs...) {}
+		
+		bool operator() (state& ps) const {
+			posn psStart = ps.posn();
+			if ( fs(ps) ) return true;
+			ps.set_posn(psStart);
+			return false;
+		}
+		
+		all_of<Fs...> fs;  ///< Parsers in sequence
+	};
+	
+	/** Matches a parser any number of times */
+	template <typename F>
+	struct many_of {
+		many_of(F f) : f(f) {}
+		
+		bool operator() (state& ps) const {
+			while ( f(ps) )
+				;
+			return true;
+		}
+		
+		F f;  ///< Repeated parser
+	};
+	
+	/** Matches a parser some positive number of times */
+	template <typename F>
+	struct some_of {
+		some_of(F f) : f(f) {}
+		
+		bool operator() (state& ps) const {
+			if ( ! f(ps) ) return false;
+			while ( f(ps) )
+				;
+			return true;
+		}
+		
+		F f;  ///< Repeated parser
+	};
+	
+	/** Matches a parser any number of times, first skipping the run of characters in a set 
+	 *  that the repetitions are known to match all of, less the last keep characters */
+	template <typename F>
+	struct many_in_of {
+		many_in_of(const scan_set& s, ind keep, F f) : s(s), keep(keep), f(f) {}
+		
+		bool operator() (state& ps) const {
+			ps.skip(s, keep);
+			while ( f(ps) )
+				;
+			return true;
+		}
+		
+		scan_set s;  ///< Characters each repetition matches exactly one of
+		ind keep;    ///< Number of characters at the end of the run to leave to the parser
+		F f;         ///< Repeated parser
+	};
+	
+	/** Matches a parser some positive number of times, first skipping the run of characters 
+	 *  in a set that the repetitions are known to match all of, less the last keep characters */
+	template <typename F>
+	struct some_in_of {
+		some_in_of(const scan_set& s, ind keep, F f) : s(s), keep(keep), f(f) {}
+		
+		bool operator() (state& ps) const {
+			posn psStart = ps.posn();
+			ps.skip(s, keep);
+			if ( ps.posn() == psStart && ! f(ps) ) return false;
+			while ( f(ps) )
+				;
+			return true;
+		}
+		
+		scan_set s;  ///< Characters each repetition matches exactly one of
+		ind keep;    ///< Number of characters at the end of the run to leave to the parser
+		F f;         ///< Repeated parser
+	};
+	
+	/** Optionally matches a parser */
+	template <typename F>
+	struct option_of {
+		option_of(F f) : f(f) {}
+		
+		bool operator() (state& ps) const {
+			f(ps);
+			return true;
+		}
+		
+		F f;  ///< Optional parser
+	};
+	
+	/** Looks ahead to match a parser without consuming input */
+	template <typename F>
+	struct look_of {
+		look_of(F f) : f(f) {}
+		
+		bool operator() (state& ps) const {
+			posn psStart = ps.posn();
+			if ( f(ps) ) { ps.set_posn(psStart); return true; }
+			return false;
+		}
+		
+		F f;  ///< Lookahead parser
+	};
+	
+	/** Looks ahead to not match a parser without consuming input */
+	template <typename F>
+	struct look_not_of {
+		look_not_of(F f) : f(f) {}
+		
+		bool operator() (state& ps) const {
+			posn psStart = ps.posn();
+			if ( f(ps) ) { ps.set_posn(psStart); return false; }
+			return true;
+		}
+		
+		F f;  ///< Lookahead parser
+	};
+	
+	/** Binds a variable to a non-terminal */
+	template <typename T>
+	struct bound {
+		bound(T& psVal, nonterminal<T> f) : psVal(psVal), f(f) {}
+		
+		bool operator() (state& ps) const { return f(ps, psVal); }
+		
+		T& psVal;          ///< Bound variable
+		nonterminal<T> f;  ///< Non-terminal to match
+	};
+	
+	/** Binds a throwaway variable to a non-terminal */
+	template <typename T>
+	struct unbound {
+		unbound(nonterminal<T> f) : f(f) {}
+		
+		bool operator() (state& ps) const { T _; return f(ps, _); }
+		
+		nonterminal<T> f;  ///< Non-terminal to match
+	};
+	
+	/** Memoizes a parser with the given memoization ID */
+	template <typename F>
+	struct memoized {
+		memoized(ind id, F f) : id(id), f(f) {}
+		
+		bool operator() (state& ps) const {
+			bool success;
+			if ( ! ps.memo(id, success) ) {
+				posn psStart = ps.posn();
+				success = f(ps);
+				ps.set_memo(psStart, id, success);
+			}
+			return success;
+		}
+		
+		ind id;  ///< Memoization ID
+		F f;     ///< Memoized parser
+	};
+	
+	/** Memoizes and binds a parser with the given memoization ID */
+	template <typename T, typename F>
+	struct memoized_bound {
+		memoized_bound(ind id, T& psVal, F f) : id(id), psVal(psVal), f(f) {}
+		
+		bool operator() (state& ps) const {
+			bool success;
+			if ( ! ps.memo(id, success, psVal) ) {
+				posn psStart = ps.posn();
+				success = f(ps);
+				ps.set_memo(psStart, id, success, psVal);
+			}
+			return success;
+		}
+		
+		ind id;    ///< Memoization ID
+		T& psVal;  ///< Bound variable
+		F f;       ///< Memoized parser
+	};
+	
+	/** Memoizes and binds a parser with the given memoization ID, moving its result out of 
+	 *  the memoization table when it is reused */
+	template <typename T, typename F>
+	struct memoized_once {
+		memoized_once(ind id, T& psVal, F f) : id(id), psVal(psVal), f(f) {}
+		
+		bool operator() (state& ps) const {
+			bool success;
+			if ( ! ps.memo_take(id, success, psVal) ) {
+				posn psStart = ps.posn();
+				success = f(ps);
+				ps.set_memo(psStart, id, success, psVal);
+			}
+			return success;
+		}
+		
+		ind id;    ///< Memoization ID
+		T& psVal;  ///< Bound variable
+		F f;       ///< Memoized parser
+	};
+	
+	/** Memoizes a repetition with the given memoization ID */
+	template <typename F>
+	struct memoized_many {
+		memoized_many(ind id, F f) : id(id), f(f) {}
+		
+		/** Matches as many repetitions as possible, memoizing the end position of the 
+		 *  repetition starting at each iteration */
+		void match(state& ps) const {
+			bool success;
+			if ( ! ps.memo(id, success) ) {
+				posn psStart = ps.posn();
+				if ( f(ps) ) {
+					match(ps);
+				}
+				ps.set_memo(psStart, id, true);
+			}
+		}
+		
+		bool operator() (state& ps) const {
+			match(ps);
+			return true;
+		}
+		
+		ind id;  ///< Memoization ID
+		F f;     ///< Repeated parser
+	};
+	
+	/** Memoizes a non-empty repetition with the given memoization ID */
+	template <typename F>
+	struct memoized_some {
+		memoized_some(ind id, F f) : many(id, f) {}
+		
+		bool operator() (state& ps) const {
+			posn psStart = ps.posn();
+			many.match(ps);
+			return ( ps.posn() > psStart );
+		}
+		
+		memoized_many<F> many;  ///< Underlying repetition
+	};
+	
+	/** Captures a string (or span, for S = parser::span) */
+	template <typename S, typename F>
+	struct captured {
+		captured(S& s, F f) : s(s), f(f) {}
+		
+		bool operator() (state& ps) const {
+			posn psStart = ps.posn();
+			if ( ! f(ps) ) return false;
+			ps.capture(psStart, s);
+			return true;
+		}
+		
+		S& s;            ///< Bound variable
+		F f;             ///< Captured parser
+	};
+	
+	/** Empty parser; always matches */
+	struct empty_match {
+		bool operator() (state&) const { return true; }
+	};
+	
+	/** Failure parser; inserts message */
+	struct failure {
+		failure(const char* s) : s(s) {}
+		
+		bool operator() (state& ps) const { ps.message(s); return false; }
+		
+		const char* s;  ///< Error message (not owned)
+	};
+	
+	/** Cut parser; always matches, discarding parser state before the current position */
+	struct cut_point {
+		bool operator() (state& ps) const { ps.cut(); return true; }
+	};
+	
+	/** Names a parser for better error messages */
+	template <typename F>
+	struct named_as {
+		named_as(const char* s, F f) : s(s), f(f) {}
+		
+		bool operator() (state& ps) const {
+			if ( f(ps) ) return true;
+			
+			ps.expect(s);
+			return false;
+		}
+		
+		const char* s;  ///< Name of parser (not owned)
+		F f;            ///< Named parser
+	};
+	
+	/** Guards a parser by the set of characters it can start with */
+	template <typename F, ind N>
+	struct guarded {
+		guarded(const charset& cs, F f, std::array<const char*, N> es) : cs(cs), f(f), es(es) {}
+		
+		bool operator() (state& ps) const {
+			if ( cs(ps()) ) return f(ps);
+			
+			if ( N == 0 ) { ps.fail(); }
+			for (const char* e : es) { ps.expect(e); }
+			return false;
+		}
+		
+		charset cs;                     ///< Characters the parser can start with
+		F f;                            ///< Guarded parser
+		std::array<const char*, N> es;  ///< Errors to report in place of the parser
+	};
+	
+	/** Character literal parser */
+	inline char_literal literal(state::value_type c) { return char_literal(c); }
+	
+	/** Character literal parser 
+	 *  @param psVal    Will be bound to character matched
+	 */
+	inline char_literal_bound literal(state::value_type c, state::value_type& psVal) {
+		return char_literal_bound(c, psVal);
+	}
+	
+	/** String literal parser; s should outlive the parser */
+	inline str_literal literal(const state::value_type* s, ind n) { return str_literal(s, n); }
+	
+	/** String literal parser for string constants */
+	template <ind N>
+	str_literal literal(const state::value_type (&s)[N]) { return str_literal(s, N-1); }
+	
+	/** Any character parser */
+	inline any_char any() { return any_char(); }
+	
+	/** Any character parser
+	 *  @param psVal    Will be bound to the character matched
+	 */
+	inline any_char_bound any(state::value_type& psVal) { return any_char_bound(psVal); }
+	
+	/** Character range parser */
+	inline char_range between(state::value_type s, state::value_type e) {
+		return char_range(s, e);
+	}
+	
+	/** Character range parser
+	 *  @param psVal    Will be bound to the character matched
+	 */
+	inline char_range_bound between(state::value_type s, state::value_type e, 
+	                                state::value_type& psVal) {
+		return char_range_bound(s, e, psVal);
+	}
+	
+	/** Character set parser */
+	inline char_set in_set(const charset& cs) { return char_set(cs); }
+	
+	/** Character set parser
+	 *  @param psVal    Will be bound to the character matched
+	 */
+	inline char_set_bound in_set(const charset& cs, state::value_type& psVal) {
+		return char_set_bound(cs, psVal);
+	}
+	
+	/** Matches all or none of a sequence of parsers */
+	template <typename... Fs>
+	sequence_of<Fs...> sequence(Fs... fs) { return sequence_of<Fs...>(fs...); }
+	
+	/** Matches one of a set of alternate parsers */
+	template <typename... Fs>
+	one_of<Fs...> choice(Fs... fs) { return one_of<Fs...>(fs...); }
+	
+	/** Matches a parser any number of times */
+	template <typename F>
+	many_of<F> many(F f) { return many_of<F>(f); }
+	
+	/** Matches a parser some positive number of times */
+	template <typename F>
+	some_of<F> some(F f) { return some_of<F>(f); }
+	
+	/** Matches a parser any number of times, first skipping the run of characters in a set 
+	 *  that the repetitions are known to match all of, less the last keep characters */
+	template <typename F>
+	many_in_of<F> many_in(const scan_set& s, ind keep, F f) { return many_in_of<F>(s, keep, f); }
+	
+	/** Matches a parser some positive number of times, first skipping the run of characters 
+	 *  in a set that the repetitions are known to match all of, less the last keep characters */
+	template <typename F>
+	some_in_of<F> some_in(const scan_set& s, ind keep, F f) { return some_in_of<F>(s, keep, f); }
+	
+	/** Optionally matches a parser */
+	template <typename F>
+	option_of<F> option(F f) { return option_of<F>(f); }
+	
+	/** Looks ahead to match a parser without consuming input */
+	template <typename F>
+	look_of<F> look(F f) { return look_of<F>(f); }
+	
+	/** Looks ahead to not match a parser without consuming input */
+	template <typename F>
+	look_not_of<F> look_not(F f) { return look_not_of<F>(f); }
+	
+	/** Binds a variable to a non-terminal */
+	template <typename T>
+	bound<T> bind(T& psVal, nonterminal<T> f) { return bound<T>(psVal, f); }
+	
+	/** Binds a throwaway variable to a non-terminal */
+	template <typename T>
+	unbound<T> unbind(nonterminal<T> f) { return unbound<T>(f); }
+	
+	/** Memoizes a parser with the given memoization ID */
+	template <typename F>
+	memoized<F> memoize(ind id, F f) { return memoized<F>(id, f); }
+	
+	/** Memoizes and binds a parser with the given memoization ID */
+	template <typename T, typename F>
+	memoized_bound<T, F> memoize(ind id, T& psVal, F f) { 
+		return memoized_bound<T, F>(id, psVal, f);
+	}
+	
+	/** Memoizes and binds a parser with the given memoization ID, moving its result out of 
+	 *  the memoization table when it is reused rather than copying it; for parsers whose 
+	 *  memoized results are reused at most once (they are recomputed if tried again) */
+	template <typename T, typename F>
+	memoized_once<T, F> memoize_once(ind id, T& psVal, F f) { 
+		return memoized_once<T, F>(id, psVal, f);
+	}
+	
+	/** Memoizes a many-matcher */
+	template <typename F>
+	memoized_many<F> memoize_many(ind id, F f) { return memoized_many<F>(id, f); }
+	
+	/** Memoizes a some-matcher */
+	template <typename F>
+	memoized_some<F> memoize_some(ind id, F f) { return memoized_some<F>(id, f); }
+	
+	/** Captures a string (or span) */
+	template <typename S, typename F>
+	captured<S, F> capture(S& s, F f) { return captured<S, F>(s, f); }
+	
+	/** Empty parser; always matches */
+	inline empty_match empty() { return empty_match(); }
+	
+	/** Failure parser; inserts message, which should outlive the parser */
+	inline failure fail(const char* s) { return failure(s); }
+	
+	/** Cut parser; always matches, discarding parser state before the current position */
+	inline cut_point cut() { return cut_point(); }
+	
+	/** Names a parser for better error messages; the name should outlive the parser */
+	template <typename F>
+	named_as<F> named(const char* s, F f) { return named_as<F>(s, f); }
+	
+	/** Guards a parser by the set of characters it can start with, reporting the given 
+	 *  "expected" errors (which should outlive the parser) if skipped */
+	template <typename F, typename... Es>
+	guarded<F, sizeof...(Es)> guard(const charset& cs, F f, Es... es) {
+		return guarded<F, sizeof...(Es)>(cs, f, {{es...}});
+	}
+	
+} /* namespace tmpl */
+} /* namespace parser */
@@ -0,0 +1,737 @@
+#pragma once
+
+/*
+ * Copyright (c) 2013 Aaron Moss
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "../ast.hpp"
+#include "../utils/strings.hpp"
+#include "first_set.hpp"
+#include "scan_loops.hpp"
+
+namespace visitor {
+	
+	/** Instruction of the backtracking machine a lexical rule is lowered to before being
+	 *  compiled to an automaton; a choice saves an alternative to resume at on failure, and
+	 *  a commit or a failed lookahead discards the most recent such alternative. */
+	struct dfa_insn {
+		enum op_t {
+			match,       ///< Consume a character in cs, or record an error n back and fail
+			choice,      ///< Save an alternative at n
+			commit,      ///< Discard the last alternative and go to n
+			fail_twice,  ///< Discard the last alternative and fail
+			expect,      ///< Record expected string n (by error mask bit)
+			fail,        ///< Fail
+			end          ///< Match
+		};
+		
+		dfa_insn(op_t op, unsigned n = 0) : op(op), n(n) {}
+		dfa_insn(const std::bitset<256>& cs, unsigned n) : op(match), cs(cs), n(n) {}
+		
+		op_t op;              ///< Operation
+		std::bitset<256> cs;  ///< Characters matched
+		unsigned n;           ///< Operand
+	}; /* struct dfa_insn */
+	
+	/** Deterministic automaton simulating a lowered lexical rule, including the errors the
+	 *  rule would report, and printed as the tables of a parser::dfa.
+	 *  Backtracking is simulated by running each saved alternative in step with the thread
+	 *  which saved it, so an automaton state is a tree of threads: the thread the rule would
+	 *  actually be running, and under each thread the alternatives it has saved, each of
+	 *  which may have saved alternatives of its own, or have already matched or failed.
+	 *  Alternatives may discard the alternatives saved before them, and only report errors
+	 *  once they would actually be run; input positions which outlive a transition, where
+	 *  an alternative matched or a pending error is, are kept in registers.
+	 *  Rules whose automata grow too large are left to the other code generators. */
+	class automaton {
+	public:
+		/** Maximum number of automaton states */
+		static const unsigned max_states = 512;
+		/** Maximum number of registers (parser::dfa::max_regs) */
+		static const unsigned max_regs = 8;
+		
+		automaton() : ok(false) {}
+		
+		/** Compiles a lowered rule; check the automaton for success.
+		 *  @param prog		The instructions of the rule
+		 *  @param names	The expected strings of the rule, by error mask bit less one
+		 */
+		automaton(const std::vector<dfa_insn>& prog, const std::vector<std::string>& names)
+			: prog(prog), names(names), ok(true) {
+			partition();
+			
+			// initial transition, before reading any input
+			thread t(0);
+			closure(t, true);
+			resolve(t);
+			
+			for (unsigned s = 0; ok && s < states.size(); ++s) {
+				for (unsigned k = 0; ok && k < n_classes; ++k) {
+					t = states[s];
+					step(t, reps[k], true);
+					trans.push_back(resolve(t));
+				}
+			}
+			
+			ok = ok && edges.size() < 0xFFFF && n_ops < 0xFFFF;
+		}
+		
+		/** @return was the automaton compiled? */
+		explicit operator bool () const { return ok; }
+		
+		/** Prints the tables of the automaton, and a statement running it.
+		 *  @param out		The stream to print to
+		 *  @param indent	The indentation of the statements
+		 */
+		void print(std::ostream& out, const std::string& indent) const {
+			out << indent << "static const std::uint8_t psClasses[] = {";
+			for (unsigned u = 0; u < 256; ++u) {
+				out << ( u % 16 == 0 ? "\n\t" + indent : " " ) << classes[u]
+				    << ( u + 1 < 256 ? "," : "" );
+			}
+			out << "};" << std::endl;
+			
+			out << indent << "static const std::uint16_t psTrans[] = {";
+			for (unsigned j = 0; j < trans.size(); ++j) {
+				out << ( j % n_classes == 0 ? "\n\t" + indent : " " ) << trans[j]
+				    << ( j + 1 < trans.size() ? "," : "" );
+			}
+			out << "};" << std::endl;
+			
+			out << indent << "static const parser::dfa_edge psEdges[] = {";
+			unsigned long k = 0;
+			for (unsigned j = 0; j < edges.size(); ++j) {
+				const edge& e = edges[j];
+				out << "\n\t" << indent << "{";
+				if ( e.to == stop ) { out << "parser::dfa::stop"; } else { out << e.to; }
+				out << ", " << k << ", " << k + e.ops.size() << "}"
+				    << ( j + 1 < edges.size() ? "," : "" );
+				k += e.ops.size();
+			}
+			out << "};" << std::endl;
+			
+			if ( n_ops > 0 ) {
+				static const char* codes[] = {
+					"record_at", "record_reg", "set_reg", "copy_reg", "match_at", "match_reg" };
+				out << indent << "static const parser::dfa_op psOps[] = {";
+				for (unsigned j = 0; j < edges.size(); ++j) {
+					for (const op& o : edges[j].ops) {
+						out << "\n\t" << indent << "{parser::dfa::" << codes[o.code] << ", "
+						    << o.a << ", " << o.b << "}" << ( --k > 0 ? "," : "" );
+					}
+				}
+				out << "};" << std::endl;
+			}
+			
+			if ( ! names.empty() ) {
+				out << indent << "static const char* const psExpected[] = {";
+				for (unsigned j = 0; j < names.size(); ++j) {
+					out << "\n\t" << indent << "\"" << strings::escape(names[j]) << "\""
+					    << ( j + 1 < names.size() ? "," : "" );
+				}
+				out << "};" << std::endl;
+			}
+			
+			// each state may skip the largest run of characters taking one transition back
+			std::vector<unsigned> runs(states.size(), 0);
+			std::vector<scan_loop> run_sets;
+			for (unsigned st = 0; st < states.size() && run_sets.size() < 0xFF; ++st) {
+				scan_loop best;
+				for (unsigned c = 0; c < n_classes; ++c) {
+					unsigned j = trans[st * n_classes + c];
+					if ( edges[j].to != st || ! repeats(edges[j]) ) continue;
+					
+					scan_loop l;
+					for (unsigned u = 1; u < 256; ++u) {
+						if ( trans[st * n_classes + classes[u]] == j ) l.chars.set(u);
+					}
+					if ( l.chars.count() > best.chars.count() ) best = l;
+				}
+				if ( best.chars.none() ) continue;
+				
+				run_sets.push_back(best);
+				runs[st] = run_sets.size();
+			}
+			
+			if ( ! run_sets.empty() ) {
+				out << indent << "static const std::uint8_t psRuns[] = {";
+				for (unsigned j = 0; j < runs.size(); ++j) {
+					out << ( j % 16 == 0 ? "\n\t" + indent : " " ) << runs[j]
+					    << ( j + 1 < runs.size() ? "," : "" );
+				}
+				out << "};" << std::endl;
+				
+				out << indent << "static const parser::scan_set psRunSets[] = {";
+				for (unsigned j = 0; j < run_sets.size(); ++j) {
+					out << "\n\t" << indent << run_sets[j].scan_set()
+					    << ( j + 1 < run_sets.size() ? "," : "" );
+				}
+				out << "};" << std::endl;
+			}
+			
+			out << indent << "static const parser::dfa psDfa = {psClasses, " << n_classes
+			    << ", psTrans, psEdges, " << ( n_ops == 0 ? "nullptr" : "psOps" ) << ", "
+			    << ( names.empty() ? "nullptr" : "psExpected" ) << ", "
+			    << ( run_sets.empty() ? "nullptr, nullptr" : "psRuns, psRunSets" ) << "};"
+			    << std::endl
+			    << std::endl
+			    << indent << "return ps.matches(psDfa);" << std::endl;
+		}
+	
+	private:
+		/** An input position: a register, or an offset back from the current position */
+		struct place {
+			place(int reg = -1, unsigned off = 0) : reg(reg), off(off) {}
+			bool operator== (const place& o) const { return reg == o.reg && off == o.off; }
+			bool operator< (const place& o) const {
+				return reg < o.reg || ( reg == o.reg && off < o.off );
+			}
+			
+			int reg;       ///< Register holding the position, or -1 for none
+			unsigned off;  ///< Offset back from the current position, if no register
+		}; /* struct place */
+		
+		/** An error, with error mask bits as for parser::dfa */
+		struct record {
+			place at;            ///< Position of the error
+			std::uint32_t mask;  ///< Errors at the position
+		}; /* struct record */
+		
+		/** A thread of the backtracking machine, with the alternatives it has saved */
+		struct thread {
+			enum kind_t { live, done, dead };
+			
+			thread(unsigned pc = 0) : kind(live), pc(pc), under(0) {}
+			
+			kind_t kind;                 ///< Is the thread running, matched, or failed?
+			unsigned pc;                 ///< Current instruction of a running thread
+			place end;                   ///< Where a matched thread matched to
+			unsigned under;              /**< Number of the alternatives saved before this
+			                              *   one the thread has discarded */
+			std::vector<record> pend;    ///< Errors to report if the thread is run
+			std::vector<thread> saved;   ///< Saved alternatives, most recent last
+		}; /* struct thread */
+		
+		/** An operation of a transition, with codes as for parser::dfa */
+		struct op {
+			enum code_t { record_at, record_reg, set_reg, copy_reg, match_at, match_reg };
+			
+			op(code_t code, unsigned a, unsigned b) : code(code), a(a), b(b) {}
+			bool operator< (const op& o) const {
+				return code < o.code || ( code == o.code
+					&& ( a < o.a || ( a == o.a && b < o.b ) ) );
+			}
+			
+			code_t code;
+			unsigned a;
+			unsigned b;
+		}; /* struct op */
+		
+		/** A transition */
+		struct edge {
+			bool operator< (const edge& o) const {
+				return to < o.to || ( to == o.to && ops < o.ops );
+			}
+			
+			unsigned to;          ///< Target state, or stop
+			std::vector<op> ops;  ///< Operations
+		}; /* struct edge */
+		
+		static const unsigned stop = 0xFFFF;
+		
+		/** Can a transition back to its state be taken for only the last two characters of
+		 *  a run of it? True if it records errors only at offsets, and copies only registers
+		 *  it sets, as the registers then depend on no more than the last two positions.
+		 *  @param e		The transition
+		 */
+		static bool repeats(const edge& e) {
+			for (const op& o : e.ops) {
+				switch ( o.code ) {
+				case op::record_at: case op::set_reg: break;
+				case op::copy_reg:
+					if ( std::none_of(e.ops.begin(), e.ops.end(), [&o](const op& p) {
+							return p.code == op::set_reg && p.a == o.b; }) ) return false;
+					break;
+				default: return false;
+				}
+			}
+			return true;
+		}
+		
+		/** Partitions the characters into classes the automaton cannot distinguish */
+		void partition() {
+			std::map<std::vector<bool>, unsigned> ids;
+			classes.resize(256);
+			for (unsigned u = 0; u < 256; ++u) {
+				std::vector<bool> key;
+				for (const dfa_insn& in : prog) {
+					if ( in.op == dfa_insn::match ) key.push_back(in.cs[u]);
+				}
+				// end of input reads as '\0', so no character class may match it
+				if ( u == 0 && std::find(key.begin(), key.end(), true) != key.end() ) ok = false;
+				
+				auto it = ids.find(key);
+				if ( it == ids.end() ) {
+					it = ids.emplace(key, reps.size()).first;
+					reps.push_back(u);
+				}
+				classes[u] = it->second;
+			}
+			n_classes = reps.size();
+		}
+		
+		/** Adds an error to a list reported together, keeping only the furthest errors where
+		 *  their order is known: of offsets from the current position the smaller is
+		 *  further, and the current position itself is past all registers */
+		static void add(std::vector<record>& rs, const record& r) {
+			if ( r.at.reg < 0 && r.at.off == 0 ) {
+				std::vector<record> ts;
+				for (const record& t : rs) {
+					if ( t.at.reg < 0 && t.at.off == 0 ) ts.push_back(t);
+				}
+				rs.swap(ts);
+			}
+			
+			for (record& t : rs) {
+				if ( t.at == r.at ) { t.mask |= r.mask; return; }
+				if ( t.at.reg < 0 && ( r.at.reg < 0 || t.at.off == 0 ) ) {
+					if ( r.at.reg < 0 && r.at.off < t.at.off ) t = r;
+					return;
+				}
+			}
+			rs.push_back(r);
+		}
+		
+		/** Records an error for a thread, reporting it now if the thread is being run */
+		void note(thread& t, bool head, const place& p, std::uint32_t mask) {
+			add(head ? out : t.pend, record{p, mask});
+		}
+		
+		/** Discards the most recent saved alternative of a thread */
+		static void discard(thread& t) {
+			if ( t.saved.empty() ) { ++t.under; } else { t.saved.pop_back(); }
+		}
+		
+		/** Fails a thread, resuming its most recent saved alternative in its place */
+		void fail(thread& t, bool head) {
+			while ( ! t.saved.empty() ) {
+				thread a = std::move(t.saved.back());
+				t.saved.pop_back();
+				
+				// the alternative runs over the remaining alternatives it has not discarded
+				unsigned n = t.saved.size();
+				unsigned kept = a.under < n ? n - a.under : 0;
+				t.saved.resize(kept);
+				t.under += a.under - ( n - kept );
+				for (thread& s : a.saved) t.saved.push_back(std::move(s));
+				
+				for (const record& r : t.pend) add(a.pend, r);
+				t.pend.swap(a.pend);
+				t.kind = a.kind;
+				t.pc = a.pc;
+				t.end = a.end;
+				if ( head ) {
+					for (const record& r : t.pend) add(out, r);
+					t.pend.clear();
+				}
+				
+				if ( t.kind == thread::done ) { t.saved.clear(); t.under = 0; }
+				if ( t.kind != thread::dead ) return;
+			}
+			t.kind = thread::dead;
+		}
+		
+		/** Runs a thread up to its next match instruction, at the current position */
+		void closure(thread& t, bool head) {
+			while ( ok && t.kind == thread::live ) {
+				if ( ++budget > 100000 ) { ok = false; return; }
+				
+				const dfa_insn& in = prog[t.pc];
+				switch ( in.op ) {
+				case dfa_insn::match:
+					return;
+				case dfa_insn::choice: {
+					thread a(in.n);
+					closure(a, false);
+					t.saved.push_back(std::move(a));
+					++t.pc;
+					break;
+				}
+				case dfa_insn::commit:
+					discard(t);
+					t.pc = in.n;
+					break;
+				case dfa_insn::fail_twice:
+					discard(t);
+					fail(t, head);
+					return;
+				case dfa_insn::expect:
+					note(t, head, place(), 1u << in.n);
+					++t.pc;
+					break;
+				case dfa_insn::fail:
+					fail(t, head);
+					return;
+				case dfa_insn::end:
+					t.kind = thread::done;
+					t.end = place();
+					t.saved.clear();
+					t.under = 0;
+					return;
+				}
+			}
+		}
+		
+		/** Steps a thread and its saved alternatives over a character */
+		void step(thread& t, unsigned char c, bool head) {
+			for (thread& a : t.saved) step(a, c, false);
+			if ( t.kind != thread::live ) return;
+			
+			const dfa_insn& in = prog[t.pc];
+			if ( in.cs[c] ) {
+				++t.pc;
+				closure(t, head);
+			} else {
+				// offsets are from the position after the character
+				if ( in.n + 1 > 0xFF ) { ok = false; return; }
+				note(t, head, place(-1, in.n + 1), 1);
+				fail(t, head);
+			}
+		}
+		
+		/** Moves the positions a thread needs into registers, in a canonical order, and
+		 *  serializes it into an automaton state key */
+		void canon(thread& t, std::map<place, unsigned>& regs, std::vector<op>& moves,
+		           std::vector<unsigned>& key) {
+			key.push_back(t.kind);
+			key.push_back(t.kind == thread::live ? t.pc : 0);
+			key.push_back(t.under);
+			if ( t.kind == thread::done ) {
+				t.end = reg(t.end, regs, moves);
+				key.push_back(t.end.reg);
+			}
+			key.push_back(t.pend.size());
+			for (record& r : t.pend) {
+				r.at = reg(r.at, regs, moves);
+				key.push_back(r.at.reg);
+				key.push_back(r.mask);
+			}
+			key.push_back(t.saved.size());
+			for (auto it = t.saved.rbegin(); it != t.saved.rend(); ++it) {
+				canon(*it, regs, moves, key);
+			}
+		}
+		
+		/** @return the register a position is moved to by the current transition */
+		place reg(const place& p, std::map<place, unsigned>& regs, std::vector<op>& moves) {
+			auto it = regs.find(p);
+			if ( it == regs.end() ) {
+				unsigned r = regs.size();
+				if ( r >= max_regs ) ok = false;
+				it = regs.emplace(p, r).first;
+				if ( p.reg < 0 ) {
+					moves.emplace_back(op::set_reg, r, p.off);
+				} else {
+					moves.emplace_back(op::copy_reg, r, p.reg);
+				}
+			}
+			return place(it->second);
+		}
+		
+		/** Ends the transition which has left the given thread running the rule, adding its
+		 *  target state if new.
+		 *  @return the index of the transition */
+		unsigned resolve(thread& t) {
+			edge e;
+			for (const record& r : out) {
+				if ( r.at.reg < 0 ) {
+					e.ops.emplace_back(op::record_at, r.at.off, r.mask);
+				} else {
+					e.ops.emplace_back(op::record_reg, r.at.reg, r.mask);
+				}
+			}
+			out.clear();
+			
+			if ( t.kind == thread::live ) {
+				std::map<place, unsigned> regs;
+				std::vector<op> moves;
+				std::vector<unsigned> key;
+				canon(t, regs, moves, key);
+				
+				// registers which only keep their values need not be moved
+				for (const op& m : moves) {
+					if ( m.code != op::copy_reg || m.a != m.b ) e.ops.push_back(m);
+				}
+				
+				auto it = ids.find(key);
+				if ( it == ids.end() ) {
+					if ( states.size() >= max_states ) { ok = false; return 0; }
+					it = ids.emplace(key, states.size()).first;
+					states.push_back(t);
+				}
+				e.to = it->second;
+			} else {
+				if ( t.kind == thread::done ) {
+					if ( t.end.reg < 0 ) {
+						e.ops.emplace_back(op::match_at, t.end.off, 0);
+					} else {
+						e.ops.emplace_back(op::match_reg, t.end.reg, 0);
+					}
+				}
+				e.to = stop;
+			}
+			
+			auto it = edge_ids.find(e);
+			if ( it == edge_ids.end() ) {
+				it = edge_ids.emplace(e, edges.size()).first;
+				edges.push_back(e);
+				n_ops += e.ops.size();
+			}
+			return it->second;
+		}
+		
+		std::vector<dfa_insn> prog;                     ///< Instructions of the rule
+		std::vector<std::string> names;                 ///< Expected strings of the rule
+		std::vector<unsigned> classes;                  ///< Class of each character
+		std::vector<unsigned char> reps;                ///< A character of each class
+		unsigned n_classes;                             ///< Number of character classes
+		std::map<std::vector<unsigned>, unsigned> ids;  ///< State indices by key
+		std::vector<thread> states;                     ///< States, as thread trees
+		std::vector<unsigned> trans;                    ///< Edges by state and class
+		std::map<edge, unsigned> edge_ids;              ///< Edge indices
+		std::vector<edge> edges;                        ///< Edges
+		unsigned long n_ops = 0;                        ///< Number of operations of all edges
+		std::vector<record> out;                        ///< Errors reported by the current edge
+		unsigned long budget = 0;                       ///< Instructions run so far
+		bool ok;                                        ///< Was the automaton compiled?
+	}; /* class automaton */
+	
+	/** Lowers lexical rules of an Egg grammar to automata: untyped rules without actions,
+	 *  bindings, captures, cuts or failure messages, which invoke only other such rules
+	 *  non-recursively, and which contain a repetition (other rules are matched in at most a
+	 *  few steps anyway). These rules match a regular language, and their automata run in
+	 *  place of the rule, without memoizing it or the rules it invokes. */
+	class automata : ast::visitor {
+	public:
+		/** Maximum number of instructions of a lowered rule */
+		static const unsigned max_insns = 4096;
+		
+		automata() : errors(true), ok(false), loops(false) {}
+		
+		/** Prepares to lower the rules of a grammar.
+		 *  @param g		The grammar
+		 *  @param errors	Should expected strings be reported? Otherwise named matchers 
+		 *  				report unexplained errors at the same positions.
+		 */
+		automata(ast::grammar& g, bool errors = true) : errors(errors), ok(false), loops(false) {
+			for (auto it = g.rs.begin(); it != g.rs.end(); ++it) {
+				rules[(*it)->name] = *it;
+			}
+		}
+		
+		/** Compiles a rule to an automaton, if it is a lexical rule as above.
+		 *  @param r		The rule
+		 *  @param a		Set to the automaton, if compiled
+		 *  @return was the rule compiled?
+		 */
+		bool operator() (ast::grammar_rule& r, automaton& a) {
+			if ( ! r.type.empty() ) return false;
+			
+			prog.clear();
+			names.clear();
+			ok = true;
+			loops = false;
+			active.clear();
+			active.insert(r.name);
+			named(r.error, r.m);
+			prog.emplace_back(dfa_insn::end);
+			if ( ! ok || ! loops || prog.size() > max_insns ) return false;
+			
+			a = automaton(prog, names);
+			return bool(a);
+		}
+		
+		void visit(ast::char_matcher& m) {
+			std::bitset<256> cs;
+			cs.set((unsigned char)m.c);
+			prog.emplace_back(cs, 0);
+		}
+		
+		void visit(ast::str_matcher& m) {
+			// a string reports its errors at its start
+			for (unsigned j = 0; j < m.s.size(); ++j) {
+				std::bitset<256> cs;
+				cs.set((unsigned char)m.s[j]);
+				prog.emplace_back(cs, j);
+			}
+		}
+		
+		void visit(ast::range_matcher& m) {
+			if ( ! m.var.empty() ) { ok = false; return; }
+			prog.emplace_back(chars(m), 0);
+		}
+		
+		void visit(ast::rule_matcher& m) {
+			// invoked rules are inlined, so must not be recursive
+			auto it = rules.find(m.rule);
+			if ( ! m.var.empty() || it == rules.end() || ! it->second->type.empty()
+			     || active.count(m.rule) ) { ok = false; return; }
+			
+			active.insert(m.rule);
+			named(it->second->error, it->second->m);
+			active.erase(m.rule);
+		}
+		
+		void visit(ast::any_matcher& m) {
+			if ( ! m.var.empty() ) { ok = false; return; }
+			// '.' does not match the end of input, read as '\0'
+			std::bitset<256> cs;
+			cs.set();
+			cs.reset(0);
+			prog.emplace_back(cs, 0);
+		}
+		
+		void visit(ast::empty_matcher&) {}
+		void visit(ast::action_matcher&) { ok = false; }
+		
+		void visit(ast::opt_matcher& m) {
+			unsigned c = emit(dfa_insn::choice);
+			m.m->accept(this);
+			unsigned k = emit(dfa_insn::commit);
+			prog[c].n = prog[k].n = prog.size();
+		}
+		
+		void visit(ast::many_matcher& m) {
+			loops = true;
+			unsigned c = emit(dfa_insn::choice);
+			m.m->accept(this);
+			emit(dfa_insn::commit, c);
+			prog[c].n = prog.size();
+		}
+		
+		void visit(ast::some_matcher& m) {
+			loops = true;
+			m.m->accept(this);
+			unsigned c = emit(dfa_insn::choice);
+			m.m->accept(this);
+			emit(dfa_insn::commit, c);
+			prog[c].n = prog.size();
+		}
+		
+		void visit(ast::seq_matcher& m) {
+			for (auto it = m.ms.begin(); ok && it != m.ms.end(); ++it) {
+				(*it)->accept(this);
+			}
+		}
+		
+		void visit(ast::alt_matcher& m) {
+			if ( m.ms.empty() ) return;
+			
+			std::vector<unsigned> ks;
+			for (auto it = m.ms.begin(); ok && it + 1 != m.ms.end(); ++it) {
+				unsigned c = emit(dfa_insn::choice);
+				(*it)->accept(this);
+				ks.push_back(emit(dfa_insn::commit));
+				prog[c].n = prog.size();
+			}
+			m.ms.back()->accept(this);
+			for (unsigned k : ks) prog[k].n = prog.size();
+		}
+		
+		void visit(ast::look_matcher& m) {
+			// &x is !!x
+			unsigned c = emit(dfa_insn::choice);
+			unsigned d = emit(dfa_insn::choice);
+			m.m->accept(this);
+			emit(dfa_insn::fail_twice);
+			prog[d].n = prog.size();
+			emit(dfa_insn::fail_twice);
+			prog[c].n = prog.size();
+		}
+		
+		void visit(ast::not_matcher& m) {
+			unsigned c = emit(dfa_insn::choice);
+			m.m->accept(this);
+			emit(dfa_insn::fail_twice);
+			prog[c].n = prog.size();
+		}
+		
+		void visit(ast::capt_matcher&) { ok = false; }
+		
+		void visit(ast::named_matcher& m) {
+			named(m.error, m.m);
+		}
+		
+		void visit(ast::fail_matcher&) { ok = false; }
+		void visit(ast::cut_matcher&) { ok = false; }
+	
+	private:
+		/** Appends an instruction.
+		 *  @return its index */
+		unsigned emit(dfa_insn::op_t op, unsigned n = 0) {
+			prog.emplace_back(op, n);
+			return prog.size() - 1;
+		}
+		
+		/** Lowers a matcher which reports an expected string if it fails */
+		void named(const std::string& error, const ast::matcher_ptr& m) {
+			if ( error.empty() ) { m->accept(this); return; }
+			
+			unsigned b = 0;
+			if ( errors ) {
+				b = std::find(names.begin(), names.end(), error) - names.begin() + 1;
+			}
+			if ( b > names.size() ) {
+				if ( b >= 32 ) { ok = false; return; }
+				names.push_back(error);
+			}
+			
+			unsigned c = emit(dfa_insn::choice);
+			m->accept(this);
+			unsigned k = emit(dfa_insn::commit);
+			prog[c].n = prog.size();
+			emit(dfa_insn::expect, b);
+			emit(dfa_insn::fail);
+			prog[k].n = prog.size();
+		}
+		
+		/** map of grammar rule names to rules */
+		std::unordered_map<std::string, ast::grammar_rule_ptr> rules;
+		std::unordered_set<std::string> active;  ///< Rules currently being inlined
+		std::vector<dfa_insn> prog;              ///< Instructions of the current rule
+		std::vector<std::string> names;          ///< Expected strings of the current rule
+		bool errors;                             ///< Report expected strings?
+		bool ok;                                 ///< Can the current rule be lowered?
+		bool loops;                              ///< Does the current rule repeat?
+	}; /* class automata */
+	
+} /* namespace visitor */
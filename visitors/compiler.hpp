@@ -29,6 +29,10 @@
 #include <utility>
 #include <vector>
 
+#include "automaton.hpp"
+#include "first_set.hpp"
+#include "literal_trie.hpp"
+#include "scan_loops.hpp"
 #include "../ast.hpp"
 #include "../utils/strings.hpp"
 
@@ -91,6 +95,11 @@ namespace visitor {
 			return !types.at(rule).empty();
 		}
 		
+		/** assuming rule exists, gets its type */
+		const std::string& type_of(const std::string& rule) const {
+			return types.at(rule);
+		}
+		
 	private:
 		/** map of grammar rule names to types */
 		std::unordered_map<std::string, std::string> types;
@@ -104,7 +113,6 @@ namespace visitor {
 	class is_lexical : ast::tree_visitor {
 	public:
 		/** Constructor; starts traversal */
-		is_lexical(ast::matcher* m) : lexical(true) { m->accept(this); }
 		is_lexical(ast::matcher_ptr m) : lexical(true) { m->accept(this); }
 		
 		operator bool () { return lexical; }
@@ -130,6 +138,8 @@ namespace visitor {
 		}
 		
 		void visit(ast::capt_matcher& m) { lexical = m.var.empty(); }
+		
+		void visit(ast::cut_matcher&) { lexical = false; }
 	private:
 		bool lexical;  ///< Is the given expression lacking in semantic elements?
 	}; /* class is_lexical */
@@ -140,24 +150,84 @@ namespace visitor {
 		using warning_list = std::vector<std::string>;
 		
 		compiler(std::string name, std::ostream& out = std::cout, bool do_guard = true) 
-			: name(name), out(out), tabs(2), do_guard(do_guard), do_memo(true), max_memo_id(0) {}
+			: name(name), out(out), tabs(2), do_guard(do_guard), do_memo(true), do_templates(false), 
+			  do_errors(true), max_memo_id(0) {}
 		
 		compiler& memo(bool b = true) { do_memo = b; return *this; }
 		compiler& no_memo() { do_memo = false; return *this; }
+		
+		/** Sets whether the generated parser reports expected strings and error messages; 
+		 *  without them it reports only the position of the furthest error */
+		compiler& errors(bool b = true) { do_errors = b; return *this; }
+		compiler& no_errors() { do_errors = false; return *this; }
+		
+		/** Targets the statically-typed combinators in templates.hpp rather than the 
+		 *  std::function-based combinators in parser.hpp */
+		compiler& templates(bool b = true) { do_templates = b; return *this; }
+		
+	private:
+		/** @return the namespace prefix of the targeted combinator library */
+		const char* lib() const { return do_templates ? "parser::tmpl::" : "parser::"; }
+		
+		/** @return the opening of a combinator list */
+		const char* list_open() const { return do_templates ? "(" : "({"; }
+		
+		/** @return the closing of a combinator list */
+		const char* list_close() const { return do_templates ? ")" : "})"; }
+		
+		/** @return a C++ expression for an error string, null if errors are not reported */
+		std::string error_string(const std::string& s) const {
+			return do_errors ? "\"" + strings::escape(s) + "\"" : "nullptr";
+		}
+		
+		/** Prints an alternative of a choice, guarded by its FIRST set if it can be skipped 
+		 *  on a non-matching lookahead character */
+		void alternative(ast::matcher_ptr& m) {
+			if ( ! firsts.guarded(m) ) {
+				m->accept(this);
+				return;
+			}
+			
+			first_set s = firsts(m);
+			out << lib() << "guard(" << s.charset() << ", ";
+			m->accept(this);
+			for (auto it = s.expected.begin(); do_errors && it != s.expected.end(); ++it) {
+				out << ", \"" << strings::escape(*it) << "\"";
+			}
+			out << ")";
+		}
+		
+		/** Prints the next alternative of a choice, merging a run of literal alternatives 
+		 *  into a trie matched in one pass, and advances past it */
+		void alternatives(std::vector<ast::matcher_ptr>::iterator& it, 
+		                  std::vector<ast::matcher_ptr>::iterator end, const std::string& indent) {
+			auto jt = literal_trie::run(it, end);
+			if ( jt - it >= 2 ) {
+				literal_trie(it, jt).print_lambda(out, indent);
+				it = jt;
+			} else {
+				alternative(*it);
+				++it;
+			}
+		}
+		
+	public:
 
 		void visit(ast::char_matcher& m) {
-			out << "parser::literal(\'" << strings::escape(m.c) << "\')";
+			out << lib() << "literal(\'" << strings::escape(m.c) << "\')";
 		}
 
 		void visit(ast::str_matcher& m) {
-			out << "parser::literal(\"" << strings::escape(m.s) << "\")";
+			out << lib() << "literal(\"" << strings::escape(m.s) << "\"";
+			if ( do_templates ) { out << ", " << m.s.size(); }
+			out << ")";
 		}
 		
 		void visit(ast::char_range& r, const std::string& var) {
 			if ( r.single() ) {
-				out << "parser::literal(\'" << strings::escape(r.to) << "\'";
+				out << lib() << "literal(\'" << strings::escape(r.to) << "\'";
 			} else {
-				out << "parser::between(\'" << strings::escape(r.from) 
+				out << lib() << "between(\'" << strings::escape(r.from) 
 				    << "\', \'" << strings::escape(r.to) << "\'";
 			}
 			
@@ -169,48 +239,27 @@ namespace visitor {
 		}
 		
 		void visit(ast::range_matcher& m) {
-			if ( m.rs.empty() ) {
-				out << "parser::empty()";
-			}
-			
-			if ( m.rs.size() == 1 ) {
+			// single ranges are cheapest to test directly
+			if ( ! m.neg && m.rs.size() == 1 ) {
 				visit(m.rs.front(), m.var);
 				return;
 			}
 			
-			std::string indent(++tabs, '\t');
-
-			//chain matcher ranges
-			out << std::endl 
-				<< indent << "parser::choice({\n"
-				<< indent << "\t"
-				;
-				
-			indent += '\t';
-			++tabs;
-			
-			auto it = m.rs.begin();
-			visit(*it, m.var);
-			
-			while ( ++it != m.rs.end() ) {
-				out << "," << std::endl
-					<< indent 
-					;
-				visit(*it, m.var);
+			// otherwise test membership in a table of the matched characters
+			out << lib() << "in_set(" << first_set::charset(chars(m));
+			if ( ! m.var.empty() ) {
+				out << ", " << m.var;
 			}
-			
-			out << "})";
-			
-			tabs -= 2;
+			out << ")";
 		}
 
 		void visit(ast::rule_matcher& m) {
 			if ( vars.rule_exists(m.rule) ) {
 				if ( vars.is_typed(m.rule) ) { // syntactic rule
 					if ( m.var.empty() ) {  // unbound
-						out << "parser::unbind(" << m.rule << ")";
+						out << lib() << "unbind(" << m.rule << ")";
 					} else {  // bound
-						out << "parser::bind(" << m.var << ", " << m.rule << ")";
+						out << lib() << "bind(" << m.var << ", " << m.rule << ")";
 					}
 					return;
 				}
@@ -223,39 +272,49 @@ namespace visitor {
 		}
 
 		void visit(ast::any_matcher& m) {
-			out << "parser::any(" << m.var << ")";
+			out << lib() << "any(" << m.var << ")";
 		}
 
 		void visit(ast::empty_matcher& m) {
-			out << "parser::empty()";
+			out << lib() << "empty()";
 		}
 
 		void visit(ast::action_matcher& m) {
-			//runs action code with all variables bound, then returns true
-			out << "[&](parser::state& ps) {" << m.a << " return true; }";
+			//runs action code with all variables bound, then returns true; unless targeting 
+			//templates, variables are rule-local statics, so need not be captured
+			out << ( do_templates ? "[&]" : "[]" ) << "(parser::state& ps) {" << m.a 
+			    << " return true; }";
 		}
 
 		void visit(ast::opt_matcher& m) {
-			out << "parser::option(";
+			out << lib() << "option(";
 			m.m->accept(this);
 			out << ")";
 		}
 
 		void visit(ast::many_matcher& m) {
-			if ( do_memo && is_lexical(m.m) ) {
-				out << "parser::memoize_many(" << ++max_memo_id << ", ";
+			scan_loop s;
+			if ( scans(m.m, s) ) {
+				// skip runs of matched characters in blocks, then finish unmemoized
+				out << lib() << "many_in(" << s.scan_set() << ", " << s.keep << ", ";
+			} else if ( do_memo && is_lexical(m.m) ) {
+				out << lib() << "memoize_many(" << ++max_memo_id << ", ";
 			} else {
-				out << "parser::many(";
+				out << lib() << "many(";
 			}
 			m.m->accept(this);
 			out << ")";
 		}
 
 		void visit(ast::some_matcher& m) {
-			if ( do_memo && is_lexical(m.m) ) {
-				out << "parser::memoize_some(" << ++max_memo_id << ", ";
+			scan_loop s;
+			if ( scans(m.m, s) ) {
+				// skip runs of matched characters in blocks, then finish unmemoized
+				out << lib() << "some_in(" << s.scan_set() << ", " << s.keep << ", ";
+			} else if ( do_memo && is_lexical(m.m) ) {
+				out << lib() << "memoize_some(" << ++max_memo_id << ", ";
 			} else {
-				out << "parser::some(";
+				out << lib() << "some(";
 			}
 			m.m->accept(this);
 			out << ")";
@@ -264,7 +323,7 @@ namespace visitor {
 		void visit(ast::seq_matcher& m) {
 			// empty sequence bad form, but always matches
 			if ( m.ms.empty() ) {
-				out << "parser::empty()";
+				out << lib() << "empty()";
 				return;
 			}
 			
@@ -277,7 +336,7 @@ namespace visitor {
 			std::string indent(++tabs, '\t');
 			
 			out << std::endl
-				<< indent << "parser::sequence({\n"
+				<< indent << lib() << "sequence" << list_open() << "\n"
 				<< indent << "\t"
 				;
 			
@@ -293,7 +352,7 @@ namespace visitor {
 				(*it)->accept(this);
 			}
 
-			out << "})";
+			out << list_close();
 
 			tabs -= 2;
 		}
@@ -301,7 +360,7 @@ namespace visitor {
 		void visit(ast::alt_matcher& m) {
 			// empty alternation bad form, but always matches
 			if ( m.ms.empty() ) {
-				out << "parser::empty()";
+				out << lib() << "empty()";
 				return;
 			}
 			
@@ -311,10 +370,16 @@ namespace visitor {
 				return;
 			}
 
+			// a choice of only literals is matched in one pass by a trie
+			if ( literal_trie::run(m.ms.begin(), m.ms.end()) == m.ms.end() ) {
+				literal_trie(m.ms.begin(), m.ms.end()).print_lambda(out, std::string(tabs, '\t'));
+				return;
+			}
+
 			std::string indent(++tabs, '\t');
 			
 			out << std::endl
-				<< indent << "parser::choice({\n"
+				<< indent << lib() << "choice" << list_open() << "\n"
 				<< indent << "\t"
 				;
 			
@@ -322,81 +387,143 @@ namespace visitor {
 			++tabs;
 
 			auto it = m.ms.begin();
-			(*it)->accept(this);
-			while ( ++it != m.ms.end() ) {
+			alternatives(it, m.ms.end(), indent);
+			while ( it != m.ms.end() ) {
 				out << "," << std::endl
 					<< indent 
 					;
-				(*it)->accept(this);
+				alternatives(it, m.ms.end(), indent);
 			}
 
-			out << "})";
+			out << list_close();
 
 			tabs -= 2;
 		}
 
 		void visit(ast::look_matcher& m) {
-			out << "parser::look(";
+			out << lib() << "look(";
 			m.m->accept(this);
 			out << ")";
 		}
 
 		void visit(ast::not_matcher& m) {
-			out << "parser::look_not(";
+			out << lib() << "look_not(";
 			m.m->accept(this);
 			out << ")";
 		}
 
 		void visit(ast::capt_matcher& m) {
-			out << "parser::capture(" << m.var << ", ";
+			out << lib() << "capture(" << m.var << ", ";
 			m.m->accept(this);
 			out << ")";
 		}
 		
 		void visit(ast::named_matcher& m) {
-			out << "parser::named(\"" << strings::escape(m.error) << "\", ";
+			out << lib() << "named(" << error_string(m.error) << ", ";
 			m.m->accept(this);
 			out << ")";
 		}
 		
 		void visit(ast::fail_matcher& m) {
-			out << "parser::fail(\"" << strings::escape(m.error) << "\")";
+			out << lib() << "fail(" << error_string(m.error) << ")";
+		}
+		
+		void visit(ast::cut_matcher& m) {
+			out << lib() << "cut()";
 		}
 
-		void compile(ast::grammar_rule& r) {
+		/** Prints the full matcher for a grammar rule */
+		void compile_matcher(ast::grammar_rule& r) {
 			bool typed = ! r.type.empty();
 			bool has_error = ! r.error.empty();
 			bool memoized = do_memo && r.memo;
-
-			//print prototype
-			out << "\tbool " << r.name << "(parser::state& ps";
-			if ( typed ) out << ", " << r.type << "& psVal";
-			out << ") {" << std::endl;
 			
-			//setup bound variables
-			std::map<std::string, std::string> vs = vars.list(r);
-			//skip parser variables
-			vs.erase("ps");
-			vs.erase("psVal");
-			for (auto it = vs.begin(); it != vs.end(); ++it) {
-				// add variable binding
-				out << "\t\t" << it->second << " " << it->first << ";" << std::endl;
-			}
-			if ( ! vs.empty() ) out << std::endl;
-
-			//apply matcher
-			out << "\t\treturn ";
 			if ( memoized ) {
-				out << "parser::memoize(" << ++max_memo_id << ", ";
+				// results reused at most once are moved out of the memo table
+				out << lib() << ( typed && r.once ? "memoize_once(" : "memoize(" ) 
+				    << ++max_memo_id << ", ";
 				if ( typed ) out << "psVal, ";
 			}
 			if ( has_error ) {
-				out << "parser::named(\"" << strings::escape(r.error) << "\", ";
+				out << lib() << "named(" << error_string(r.error) << ", ";
 			}
 			r.m->accept(this);
 			if ( has_error ) { out << ")"; }
 			if ( memoized ) { out << ")"; }
-			out << "(ps);";
+		}
+		
+		void compile(ast::grammar_rule& r) {
+			bool typed = ! r.type.empty();
+			
+			//regular lexical rules run as automata
+			automaton a;
+			if ( dfas(r, a) ) {
+				out << "\tbool " << r.name << "(parser::state& ps) {" << std::endl;
+				a.print(out, "\t\t");
+				out << "\t}" << std::endl
+				    << std::endl;
+				return;
+			}
+			
+			//setup bound variables
+			std::map<std::string, std::string> vs = vars.list(r);
+			//skip parser variables
+			vs.erase("ps");
+			vs.erase("psVal");
+			
+			if ( do_templates ) {
+				//print prototype
+				out << "\tbool " << r.name << "(parser::state& ps";
+				if ( typed ) out << ", " << r.type << "& psVal";
+				out << ") {" << std::endl;
+				
+				for (auto it = vs.begin(); it != vs.end(); ++it) {
+					// add variable binding
+					out << "\t\t" << it->second << " " << it->first << ";" << std::endl;
+				}
+				if ( ! vs.empty() ) out << std::endl;
+				
+				//apply matcher; templated combinators are cheap to build for each invocation
+				out << "\t\treturn ";
+				compile_matcher(r);
+				out << "(ps);";
+			} else {
+				//print prototype
+				out << "\tbool " << r.name << "(parser::state& ps";
+				if ( typed ) out << ", " << r.type << "& psOut";
+				out << ") {" << std::endl;
+				
+				//variables are shared between invocations of the rule so that the rule's 
+				//combinator can be bound to them once
+				if ( typed ) {
+					out << "\t\tstatic thread_local " << r.type << " psVal;" << std::endl;
+				}
+				for (auto it = vs.begin(); it != vs.end(); ++it) {
+					// add variable binding
+					out << "\t\tstatic thread_local " << it->second << " " << it->first << ";" 
+					    << std::endl;
+				}
+				out << std::endl;
+				
+				//build matcher on first invocation
+				out << "\t\tstatic thread_local const parser::combinator psRule = ";
+				compile_matcher(r);
+				out << ";" << std::endl
+				    << std::endl;
+				
+				//save variables of any enclosing invocation of this rule
+				if ( typed ) {
+					out << "\t\tparser::frame_slot<" << r.type << "> psFrame_psVal(psVal, psOut);" 
+					    << std::endl;
+				}
+				for (auto it = vs.begin(); it != vs.end(); ++it) {
+					out << "\t\tparser::frame_slot<" << it->second << "> psFrame_" << it->first 
+					    << "(" << it->first << ");" << std::endl;
+				}
+				
+				//apply matcher
+				out << "\t\treturn psRule(ps);";
+			}
 
 			//close out method
 			out << "\n"
@@ -427,7 +554,8 @@ namespace visitor {
 
 			//get needed includes
 			out << "#include <string>" << std::endl
-				<< "#include \"parser.hpp\"" << std::endl
+				<< "#include \"" << ( do_templates ? "templates.hpp" : "parser.hpp" ) << "\"" 
+				<< std::endl
 				<< std::endl
 				;
 
@@ -449,6 +577,9 @@ namespace visitor {
 
 			//set up lists of variable types and memoization IDs
 			vars = variable_list(g);
+			firsts = first_sets(g);
+			scans = scan_loops(g, firsts);
+			dfas = automata(g, do_errors);
 			
 			//generate matching functions
 			for (auto it = g.rs.begin(); it != g.rs.end(); ++it) {
@@ -477,10 +608,17 @@ namespace visitor {
 		std::string name;	        ///< Name of the grammar
 		std::ostream& out;	        ///< Output stream to print to
 		variable_list vars;	        ///< Holds grammar rule types
+		first_sets firsts;          ///< Holds grammar FIRST sets
+		scan_loops scans;           ///< Finds repetitions which may be scanned
+		automata dfas;              ///< Compiles regular lexical rules to automata
 		warning_list warnings;      ///< Holds warnings
 		bool do_guard;              ///< Add include guard to generated file?
 		bool do_memo;               /**< if true, memoize if grammar says, otherwise no 
 		                             *   memoization [default true] */
+		bool do_templates;          /**< if true, target templates.hpp rather than 
+		                             *   parser.hpp combinators [default false] */
+		bool do_errors;             /**< if true, report expected strings and error 
+		                             *   messages [default true] */
 		unsigned long max_memo_id;  ///< Largest currently used memoization ID
 		int tabs;			        ///< Number of tabs for printer
 	}; /* class compiler */
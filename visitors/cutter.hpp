@@ -0,0 +1,206 @@
+#pragma once
+
+/*
+ * Copyright (c) 2013 Aaron Moss
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "../ast.hpp"
+
+namespace visitor {
+	
+	/** AST visitor with function-like interface that collects the names of all rules invoked 
+	 *  by an expression. */
+	class rule_refs : ast::tree_visitor {
+	public:
+		/** Constructor; traverses every rule of the grammar */
+		rule_refs(ast::grammar& g) {
+			for (auto it = g.rs.begin(); it != g.rs.end(); ++it) {
+				(*it)->m->accept(this);
+			}
+		}
+		
+		/** @return is the named rule invoked anywhere in the grammar? */
+		bool operator() (const std::string& s) const { return names.count(s) > 0; }
+		
+		void visit(ast::rule_matcher& m) { names.insert(m.rule); }
+	private:
+		std::unordered_set<std::string> names;  ///< Names of the invoked rules
+	}; /* class rule_refs */
+	
+	/** AST visitor with function-like interface that checks if an expression binds a 
+	 *  variable of type parser::span, which refers to the input rather than copying it. */
+	class span_binds : ast::tree_visitor {
+	public:
+		/** Constructor
+		 *  @param g		The grammar the expression belongs to
+		 *  @param r		The rule the expression belongs to, for the type of psVal
+		 */
+		span_binds(ast::grammar& g, ast::grammar_rule& r) : g(g), r(r), found(false) {}
+		
+		/** @return does the given matcher bind a span? */
+		bool operator() (ast::matcher_ptr m) {
+			found = false;
+			m->accept(this);
+			return found;
+		}
+		
+		void visit(ast::rule_matcher& m) {
+			if ( m.var.empty() ) return;
+			auto it = g.names.find(m.rule);
+			if ( it != g.names.end() && is_span(it->second->type) ) { found = true; }
+		}
+		
+		void visit(ast::capt_matcher& m) {
+			// captures only bind spans through the rule's own return value
+			if ( m.var == "psVal" && is_span(r.type) ) { found = true; }
+			m.m->accept(this);
+		}
+		
+	private:
+		/** @return is the given type parser::span? */
+		static bool is_span(std::string t) {
+			t.erase(std::remove_if(t.begin(), t.end(), ::isspace), t.end());
+			return t == "parser::span" || t == "::parser::span";
+		}
+		
+		ast::grammar& g;       ///< The grammar, for the types of invoked rules
+		ast::grammar_rule& r;  ///< The rule, for the type of psVal
+		bool found;            ///< Has a span binding been found?
+	}; /* class span_binds */
+	
+	/** Inserts cuts into an Egg AST at points the parser can never backtrack past. 
+	 *  The first rule of a grammar is its entry point; if no rule invokes it, a failure 
+	 *  anywhere in it is a failure of the whole parse, so its state may be cut after each of 
+	 *  its top-level sequence elements and after each iteration of its top-level repetitions. 
+	 *  Cutting discards the input behind the cut, so no cuts are inserted after (or in) the 
+	 *  first element which binds a parser::span, as the span may still be read by a later 
+	 *  action; spans which actions store outside the rule are not tracked. Backtracking past 
+	 *  an inserted cut throws parser::forgotten_state_error, so a grammar which would have 
+	 *  matched by backtracking into an earlier element may no longer match; harnesses for 
+	 *  grammars compiled with these cuts should treat that exception as a parse failure. */
+	class cutter {
+	public:
+		/** Inserts cuts into the given grammar.
+		 *  @param g		The grammar to modify
+		 *  @return the modified grammar
+		 */
+		ast::grammar& cut(ast::grammar& g) {
+			if ( g.rs.empty() ) return g;
+			
+			ast::grammar_rule& r = *g.rs.front();
+			if ( rule_refs(g)(r.name) ) return g;
+			
+			this->g = &g;
+			span_binds binds(g, r);
+			r.m = cut_top(r.m, binds);
+			return g;
+		}
+		
+	private:
+		/** @return may this matcher consume input? */
+		static bool consumes(const ast::matcher_ptr& m) {
+			switch ( m->type() ) {
+			case ast::empty_type: case ast::action_type: case ast::look_type: 
+			case ast::not_type:   case ast::fail_type:   case ast::cut_type:
+				return false;
+			default:
+				return true;
+			}
+		}
+		
+		/** @return is this matcher a repetition? */
+		static bool is_loop(const ast::matcher_ptr& m) {
+			return m->type() == ast::many_type || m->type() == ast::some_type;
+		}
+		
+		/** @return the given repetition body, followed by a cut */
+		ast::matcher_ptr cut_after(ast::matcher_ptr m) {
+			if ( m->type() == ast::cut_type ) return m;
+			
+			if ( m->type() == ast::seq_type ) {
+				ast::seq_matcher_ptr s = ast::as_ptr<ast::seq_matcher>(m);
+				if ( ! s->ms.empty() && s->ms.back()->type() == ast::cut_type ) return m;
+				*s += g->make<ast::cut_matcher>();
+				return m;
+			}
+			
+			ast::seq_matcher_ptr s = g->make<ast::seq_matcher>();
+			*s += m;
+			*s += g->make<ast::cut_matcher>();
+			return s;
+		}
+		
+		/** Cuts each iteration of a repetition; other matchers are returned unchanged */
+		ast::matcher_ptr cut_loop(ast::matcher_ptr m) {
+			switch ( m->type() ) {
+			case ast::many_type: {
+				ast::many_matcher_ptr l = ast::as_ptr<ast::many_matcher>(m);
+				l->m = cut_after(l->m);
+				return m;
+			} case ast::some_type: {
+				ast::some_matcher_ptr l = ast::as_ptr<ast::some_matcher>(m);
+				l->m = cut_after(l->m);
+				return m;
+			} default:
+				return m;
+			}
+		}
+		
+		/** Inserts cuts into the top-level matcher of the entry rule */
+		ast::matcher_ptr cut_top(ast::matcher_ptr m, span_binds& binds) {
+			if ( m->type() != ast::seq_type ) return binds(m) ? m : cut_loop(m);
+			
+			// rebuilds the element list in place of the old one
+			ast::seq_matcher_ptr s = ast::as_ptr<ast::seq_matcher>(m);
+			std::vector<ast::matcher_ptr> ms;
+			ms.reserve(2 * s->ms.size());
+			for (auto it = s->ms.begin(); it != s->ms.end(); ++it) {
+				// stop cutting once a span of the input may be live
+				if ( binds(*it) ) {
+					ms.insert(ms.end(), it, s->ms.end());
+					break;
+				}
+				
+				ms.push_back(cut_loop(*it));
+				
+				// no need to cut after the last element, twice in a row, or after a 
+				// repetition which has already cut its last iteration
+				auto nx = it + 1;
+				if ( nx != s->ms.end() && consumes(*it) && ! is_loop(*it) 
+						&& (*nx)->type() != ast::cut_type ) {
+					ms.push_back(g->make<ast::cut_matcher>());
+				}
+			}
+			s->ms.swap(ms);
+			return s;
+		}
+		
+		ast::grammar* g;  ///< The grammar being cut, which owns the matchers built
+	}; /* class cutter */
+	
+} /* namespace visitor */
+
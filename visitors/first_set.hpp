@@ -0,0 +1,291 @@
+#pragma once
+
+/*
+ * Copyright (c) 2013 Aaron Moss
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <bitset>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+#include "../ast.hpp"
+
+namespace visitor {
+	
+	/** The FIRST set of an Egg matcher: the characters a match of it may start with, 
+	 *  whether it may match without consuming input, and the errors it reports when run on 
+	 *  a character outside the set. */
+	struct first_set {
+		first_set() : nullable(false), opaque(false) {}
+		
+		/** Unions the characters, expected errors and opacity of another FIRST set into this 
+		 *  one, as for a matcher run after it on the same character */
+		first_set& operator |= (const first_set& o) {
+			chars |= o.chars;
+			expected.insert(o.expected.begin(), o.expected.end());
+			opaque = opaque || o.opaque;
+			return *this;
+		}
+		
+		bool operator == (const first_set& o) const {
+			return chars == o.chars && expected == o.expected 
+				&& nullable == o.nullable && opaque == o.opaque;
+		}
+		bool operator != (const first_set& o) const { return ! (*this == o); }
+		
+		/** @return may the matcher be skipped (recording a failure) when the current 
+		 *          character is not in its set? Only non-nullable matchers which cannot 
+		 *          run actions, bind variables, or report messages before failing on their 
+		 *          first character qualify. */
+		bool guardable() const { return ! nullable && ! opaque && ! chars.all(); }
+		
+		/** @return a C++ expression for a parser::charset of the characters */
+		std::string charset() const { return charset(chars); }
+		
+		/** @return a C++ expression for a parser::charset of the given characters */
+		static std::string charset(const std::bitset<256>& chars) {
+			std::stringstream ss;
+			ss << "parser::charset{{";
+			for (unsigned w = 0; w < 8; ++w) {
+				unsigned long bits = 0;
+				for (unsigned b = 0; b < 32; ++b) {
+					if ( chars[32*w + b] ) bits |= 1ul << b;
+				}
+				if ( w > 0 ) ss << ", ";
+				ss << "0x" << std::hex << std::setw(8) << std::setfill('0') << bits << "u";
+			}
+			ss << "}}";
+			return ss.str();
+		}
+		
+		std::bitset<256> chars;           ///< Characters a match may start with
+		std::set<std::string> expected;   /**< "Expected" errors reported at the current 
+		                                   *   position when run on another character */
+		bool nullable;                    ///< May the matcher match without consuming input?
+		bool opaque;                      /**< May the matcher have effects other than 
+		                                   *   reporting its expected errors when run on 
+		                                   *   another character (or is it too complex to 
+		                                   *   analyze)? */
+	}; /* struct first_set */
+	
+	/** @return the set of characters matched by a character class */
+	static std::bitset<256> chars(const ast::range_matcher& m) {
+		std::bitset<256> cs;
+		for (auto it = m.rs.begin(); it != m.rs.end(); ++it) {
+			// compare as plain chars, as the range tests of the generated parsers do
+			for (unsigned u = 0; u < 256; ++u) {
+				char c = (char)u;
+				if ( it->from <= c && c <= it->to ) cs.set(u);
+			}
+		}
+		
+		// negated classes do not match the end of input, read as '\0'
+		if ( m.neg ) { cs.flip(); cs.reset(0); }
+		return cs;
+	}
+	
+	/** Computes the FIRST sets of the matchers of an Egg grammar. 
+	 *  Rule FIRST sets are found by fixed-point iteration over the grammar; the FIRST set of 
+	 *  any matcher may then be queried. Lookahead is treated as opaque. */
+	class first_sets : ast::visitor {
+	public:
+		first_sets() {}
+		
+		first_sets(ast::grammar& g) {
+			for (auto it = g.rs.begin(); it != g.rs.end(); ++it) {
+				rules[(*it)->name] = first_set();
+			}
+			
+			// find nullability first, then start again from empty sets, as the errors 
+			// reported by an alternation depend on the nullability of its alternatives
+			iterate(g);
+			for (auto it = rules.begin(); it != rules.end(); ++it) {
+				bool nullable = it->second.nullable;
+				it->second = first_set();
+				it->second.nullable = nullable;
+			}
+			iterate(g);
+		}
+		
+		/** @return the FIRST set of the given matcher */
+		first_set operator() (const ast::matcher_ptr& m) {
+			m->accept(this);
+			return rVal;
+		}
+		
+		/** @return should the given alternative of a choice be guarded by its FIRST set? 
+		 *  True if it is guardable and not a terminal which would test the current 
+		 *  character itself at no greater cost. */
+		bool guarded(const ast::matcher_ptr& m) {
+			switch ( m->type() ) {
+			case ast::char_type: case ast::str_type: case ast::range_type: case ast::any_type:
+				return false;
+			default:
+				return (*this)(m).guardable();
+			}
+		}
+		
+		void visit(ast::char_matcher& m) {
+			rVal = first_set();
+			rVal.chars.set((unsigned char)m.c);
+		}
+		
+		void visit(ast::str_matcher& m) {
+			rVal = first_set();
+			if ( m.s.empty() ) { rVal.nullable = true; }
+			else { rVal.chars.set((unsigned char)m.s[0]); }
+		}
+		
+		void visit(ast::range_matcher& m) {
+			rVal = first_set();
+			rVal.chars = chars(m);
+		}
+		
+		void visit(ast::rule_matcher& m) {
+			auto it = rules.find(m.rule);
+			if ( it == rules.end() ) {  // undefined rule
+				rVal = first_set();
+				rVal.nullable = rVal.opaque = true;
+				return;
+			}
+			
+			rVal = it->second;
+			// a nullable rule may bind its variable without consuming input
+			if ( rVal.nullable && ! m.var.empty() ) { rVal.opaque = true; }
+		}
+		
+		void visit(ast::any_matcher& m) {
+			rVal = first_set();
+			rVal.chars.set();
+		}
+		
+		void visit(ast::empty_matcher& m) {
+			rVal = first_set();
+			rVal.nullable = true;
+		}
+		
+		void visit(ast::action_matcher& m) {
+			rVal = first_set();
+			rVal.nullable = rVal.opaque = true;
+		}
+		
+		void visit(ast::opt_matcher& m) {
+			m.m->accept(this);
+			rVal.nullable = true;
+		}
+		
+		void visit(ast::many_matcher& m) {
+			m.m->accept(this);
+			rVal.nullable = true;
+		}
+		
+		void visit(ast::some_matcher& m) {
+			m.m->accept(this);
+		}
+		
+		void visit(ast::seq_matcher& m) {
+			first_set s;
+			s.nullable = true;
+			// union the elements up to the first which must consume input
+			for (auto it = m.ms.begin(); it != m.ms.end(); ++it) {
+				first_set e = (*this)(*it);
+				s |= e;
+				if ( ! e.nullable ) { s.nullable = false; break; }
+			}
+			rVal = s;
+		}
+		
+		void visit(ast::alt_matcher& m) {
+			first_set s;
+			// an empty alternation always matches
+			if ( m.ms.empty() ) { s.nullable = true; }
+			for (auto it = m.ms.begin(); it != m.ms.end(); ++it) {
+				first_set e = (*this)(*it);
+				if ( s.nullable ) {
+					// not tried on another character; may still start a match
+					s.chars |= e.chars;
+					s.opaque = s.opaque || e.opaque;
+				} else {
+					s |= e;
+					s.nullable = e.nullable;
+				}
+			}
+			rVal = s;
+		}
+		
+		void visit(ast::look_matcher& m) {
+			rVal = first_set();
+			rVal.nullable = rVal.opaque = true;
+		}
+		
+		void visit(ast::not_matcher& m) {
+			rVal = first_set();
+			rVal.nullable = rVal.opaque = true;
+		}
+		
+		void visit(ast::capt_matcher& m) {
+			m.m->accept(this);
+			// a nullable capture may bind its variable without consuming input
+			if ( rVal.nullable && ! m.var.empty() ) { rVal.opaque = true; }
+		}
+		
+		void visit(ast::named_matcher& m) {
+			m.m->accept(this);
+			if ( ! rVal.nullable ) { rVal.expected.insert(m.error); }
+		}
+		
+		void visit(ast::fail_matcher& m) {
+			rVal = first_set();
+			rVal.opaque = true;
+		}
+		
+		void visit(ast::cut_matcher& m) {
+			rVal = first_set();
+			rVal.nullable = true;
+		}
+		
+	private:
+		/** Recomputes the rule FIRST sets until they reach a fixed point */
+		void iterate(ast::grammar& g) {
+			bool changed;
+			do {
+				changed = false;
+				for (auto it = g.rs.begin(); it != g.rs.end(); ++it) {
+					ast::grammar_rule& r = **it;
+					first_set s = (*this)(r.m);
+					// rule failure reports the rule's error string
+					if ( ! r.error.empty() && ! s.nullable ) { s.expected.insert(r.error); }
+					
+					first_set& old = rules[r.name];
+					if ( s != old ) { old = s; changed = true; }
+				}
+			} while ( changed );
+		}
+		
+		std::unordered_map<std::string, first_set> rules;  ///< FIRST sets of grammar rules
+		first_set rVal;                                     ///< FIRST set of the current visit
+	}; /* class first_sets */
+	
+} /* namespace visitor */
+
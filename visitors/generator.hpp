@@ -0,0 +1,527 @@
+#pragma once
+
+/*
+ * Copyright (c) 2013 Aaron Moss
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "compiler.hpp"
+#include "../ast.hpp"
+#include "../utils/strings.hpp"
+
+namespace visitor {
+	
+	/** Direct code generator for Egg matcher ASTs.
+	 *  Where visitor::compiler builds a tree of parser combinators for each rule, this 
+	 *  generator lowers each matcher to inline recursive-descent control flow: every 
+	 *  backtracking point saves its position in a local variable, and failures jump to the 
+	 *  label of the nearest enclosing matcher which can recover from them. Generated rules 
+	 *  construct no combinator objects and make no indirect calls other than to other rules. 
+	 *  Repetitions are not memoized by this backend, only rules. */
+	class generator : ast::visitor {
+	public:
+		using warning_list = std::vector<std::string>;
+		
+		generator(std::string name, std::ostream& out = std::cout, bool do_guard = true) 
+			: name(name), out(out), do_guard(do_guard), do_memo(true), do_errors(true), 
+			  max_memo_id(0), n_posns(0), n_labels(0) {}
+		
+		generator& memo(bool b = true) { do_memo = b; return *this; }
+		generator& no_memo() { do_memo = false; return *this; }
+		
+		/** Sets whether the generated parser reports expected strings and error messages; 
+		 *  without them it reports only the position of the furthest error */
+		generator& errors(bool b = true) { do_errors = b; return *this; }
+		generator& no_errors() { do_errors = false; return *this; }
+		
+	private:
+		/** @return a fresh backtracking position variable */
+		std::string new_posn() {
+			std::stringstream ss;
+			ss << "psP" << ++n_posns;
+			return ss.str();
+		}
+		
+		/** @return a fresh label name */
+		std::string new_label() {
+			std::stringstream ss;
+			ss << "psL" << ++n_labels;
+			return ss.str();
+		}
+		
+		/** Starts a new statement in the rule body */
+		std::ostream& line() { return body << "\t\t"; }
+		
+		/** @return a jump to the current failure label */
+		std::string fail_jump() {
+			used.insert(fail);
+			return "goto " + fail + ";";
+		}
+		
+		/** @return a statement reporting the given error through the given state method, 
+		 *  or an unexplained failure if errors are not reported */
+		std::string report(const char* method, const std::string& s) const {
+			if ( ! do_errors ) return "ps.fail();";
+			return std::string("ps.") + method + "(\"" + strings::escape(s) + "\");";
+		}
+		
+		/** Prints a forward label, if any jumps to it have been generated */
+		void label(const std::string& l) {
+			if ( used.count(l) ) { body << "\t" << l << ": ;" << std::endl; }
+		}
+		
+		/** Generates code for a matcher with the given failure label */
+		void gen(ast::matcher_ptr& m, const std::string& l) {
+			std::string old = fail;
+			fail = l;
+			m->accept(this);
+			fail = old;
+		}
+		
+		/** Generates a check that the current character may start the given matcher, jumping 
+		 *  to the given label otherwise; omitted if the matcher cannot be skipped that way */
+		void guard(ast::matcher_ptr& m, const std::string& l) {
+			if ( ! firsts.guarded(m) ) return;
+			
+			first_set s = firsts(m);
+			std::string old = fail;
+			fail = l;
+			line() << "if ( ! " << s.charset() << "(ps()) ) { ";
+			if ( s.expected.empty() || ! do_errors ) { body << "ps.fail(); "; }
+			for (auto it = s.expected.begin(); do_errors && it != s.expected.end(); ++it) {
+				body << "ps.expect(\"" << strings::escape(*it) << "\"); ";
+			}
+			body << fail_jump() << " }" << std::endl;
+			fail = old;
+		}
+		
+		/** Generates a match of a run of literal alternatives by a trie, jumping to the 
+		 *  given labels on success or failure */
+		void trie(std::vector<ast::matcher_ptr>::iterator begin, 
+		          std::vector<ast::matcher_ptr>::iterator end, 
+		          const std::string& ok, const std::string& l) {
+			std::string old = fail;
+			fail = l;
+			used.insert(ok);
+			literal_trie(begin, end).print(body, "\t\t", "goto " + ok + ";", fail_jump());
+			fail = old;
+		}
+		
+	public:
+		void visit(ast::char_matcher& m) {
+			line() << "if ( ! ps.matches(\'" << strings::escape(m.c) << "\') ) { "
+			       << "ps.fail(); " << fail_jump() << " }" << std::endl;
+		}
+
+		void visit(ast::str_matcher& m) {
+			line() << "if ( ! ps.matches(\"" << strings::escape(m.s) << "\", " << m.s.size() 
+			       << ") ) { ps.fail(); " << fail_jump() << " }" << std::endl;
+		}
+		
+		void visit(ast::range_matcher& m) {
+			line() << "if ( ! ps.matches_in(";
+			if ( ! m.neg && m.rs.size() == 1 ) {
+				// single ranges are cheapest to test directly
+				const ast::char_range& r = m.rs.front();
+				body << "\'" << strings::escape(r.from) << "\', \'" << strings::escape(r.to) << "\'";
+			} else {
+				// otherwise test membership in a table of the matched characters
+				body << first_set::charset(chars(m));
+			}
+			if ( ! m.var.empty() ) { body << ", " << m.var; }
+			body << ") ) { ps.fail(); " << fail_jump() << " }" << std::endl;
+		}
+
+		void visit(ast::rule_matcher& m) {
+			if ( vars.rule_exists(m.rule) ) {
+				if ( vars.is_typed(m.rule) ) { // syntactic rule
+					if ( m.var.empty() ) {  // unbound
+						line() << "{ " << vars.type_of(m.rule) << " psU; "
+						       << "if ( ! " << m.rule << "(ps, psU) ) " << fail_jump() 
+						       << " }" << std::endl;
+					} else {  // bound
+						line() << "if ( ! " << m.rule << "(ps, " << m.var << ") ) " 
+						       << fail_jump() << std::endl;
+					}
+					return;
+				}
+			} else {
+				warnings.emplace_back("Rule \"" + m.rule + "\" is not defined");
+			}
+			
+			// otherwise lexical rule
+			line() << "if ( ! " << m.rule << "(ps) ) " << fail_jump() << std::endl;
+		}
+
+		void visit(ast::any_matcher& m) {
+			line() << "if ( ! ps.matches_any(" << m.var << ") ) { "
+			       << "ps.fail(); " << fail_jump() << " }" << std::endl;
+		}
+
+		void visit(ast::empty_matcher& m) {}
+		
+		void visit(ast::cut_matcher& m) {
+			line() << "ps.cut();" << std::endl;
+		}
+
+		void visit(ast::action_matcher& m) {
+			//runs action code with all variables bound, failing if it returns false
+			line() << "if ( ! [&]() -> bool {" << m.a << " return true; }() ) " 
+			       << fail_jump() << std::endl;
+		}
+
+		void visit(ast::opt_matcher& m) {
+			std::string p = new_posn(), l = new_label(), ok = new_label();
+			
+			line() << p << " = ps.posn();" << std::endl;
+			gen(m.m, l);
+			if ( used.count(l) ) {
+				line() << "goto " << ok << ";" << std::endl;
+				used.insert(ok);
+				label(l);
+				line() << "ps.set_posn(" << p << ");" << std::endl;
+				label(ok);
+			}
+		}
+
+		/** Prints a skip of the run of characters a repetition is known to match, if any */
+		void skip(ast::matcher_ptr& m) {
+			scan_loop s;
+			if ( ! scans(m, s) ) return;
+			
+			line() << "ps.skip(" << s.scan_set();
+			if ( s.keep > 0 ) { body << ", " << s.keep; }
+			body << ");" << std::endl;
+		}
+		
+		void visit(ast::many_matcher& m) {
+			std::string p = new_posn(), loop = new_label(), l = new_label();
+			
+			skip(m.m);
+			body << "\t" << loop << ":" << std::endl;
+			line() << p << " = ps.posn();" << std::endl;
+			gen(m.m, l);
+			line() << "goto " << loop << ";" << std::endl;
+			label(l);
+			line() << "ps.set_posn(" << p << ");" << std::endl;
+		}
+
+		void visit(ast::some_matcher& m) {
+			std::string s = new_posn(), p = new_posn(), loop = new_label(), l = new_label();
+			
+			line() << s << " = ps.posn();" << std::endl;
+			skip(m.m);
+			body << "\t" << loop << ":" << std::endl;
+			line() << p << " = ps.posn();" << std::endl;
+			gen(m.m, l);
+			line() << "goto " << loop << ";" << std::endl;
+			label(l);
+			line() << "ps.set_posn(" << p << ");" << std::endl;
+			// fail if no iterations matched
+			line() << "if ( " << p << " == " << s << " ) " << fail_jump() << std::endl;
+		}
+		
+		void visit(ast::seq_matcher& m) {
+			for (auto it = m.ms.begin(); it != m.ms.end(); ++it) {
+				gen(*it, fail);
+			}
+		}
+		
+		void visit(ast::alt_matcher& m) {
+			// empty alternation bad form, but always matches
+			if ( m.ms.empty() ) return;
+			
+			// singleton alternation also bad form, equivalent to the single matcher
+			if ( m.ms.size() == 1 ) {
+				gen(m.ms.front(), fail);
+				return;
+			}
+			
+			// a choice of only literals is matched in one pass by a trie
+			if ( literal_trie::run(m.ms.begin(), m.ms.end()) == m.ms.end() ) {
+				std::string ok = new_label();
+				trie(m.ms.begin(), m.ms.end(), ok, fail);
+				label(ok);
+				return;
+			}
+			
+			std::string p = new_posn(), ok = new_label();
+			
+			line() << p << " = ps.posn();" << std::endl;
+			auto it = m.ms.begin();
+			while ( true ) {
+				// a run of literal alternatives is merged into a trie
+				auto jt = literal_trie::run(it, m.ms.end());
+				if ( jt - it < 2 ) { jt = it + 1; }
+				
+				// last alternative fails to the enclosing matcher
+				std::string l = ( jt == m.ms.end() ) ? fail : new_label();
+				if ( jt - it >= 2 ) {
+					trie(it, jt, ok, l);
+				} else {
+					guard(*it, l);
+					gen(*it, l);
+					if ( jt != m.ms.end() ) {
+						line() << "goto " << ok << ";" << std::endl;
+						used.insert(ok);
+					}
+				}
+				if ( jt == m.ms.end() ) break;
+				
+				label(l);
+				line() << "ps.set_posn(" << p << ");" << std::endl;
+				it = jt;
+			}
+			label(ok);
+		}
+
+		void visit(ast::look_matcher& m) {
+			std::string p = new_posn();
+			
+			line() << p << " = ps.posn();" << std::endl;
+			gen(m.m, fail);
+			line() << "ps.set_posn(" << p << ");" << std::endl;
+		}
+
+		void visit(ast::not_matcher& m) {
+			std::string p = new_posn(), l = new_label();
+			
+			line() << p << " = ps.posn();" << std::endl;
+			gen(m.m, l);
+			line() << "ps.set_posn(" << p << "); " << fail_jump() << std::endl;
+			label(l);
+			line() << "ps.set_posn(" << p << ");" << std::endl;
+		}
+
+		void visit(ast::capt_matcher& m) {
+			std::string p = new_posn();
+			
+			line() << p << " = ps.posn();" << std::endl;
+			gen(m.m, fail);
+			line() << "ps.capture(" << p << ", " << m.var << ");" << std::endl;
+		}
+		
+		void visit(ast::named_matcher& m) {
+			std::string p = new_posn(), l = new_label(), ok = new_label();
+			
+			line() << p << " = ps.posn();" << std::endl;
+			gen(m.m, l);
+			if ( used.count(l) ) {
+				line() << "goto " << ok << ";" << std::endl;
+				used.insert(ok);
+				label(l);
+				line() << "ps.set_posn(" << p << "); " << report("expect", m.error) << " " 
+				       << fail_jump() << std::endl;
+				label(ok);
+			}
+		}
+		
+		void visit(ast::fail_matcher& m) {
+			line() << report("message", m.error) << " " << fail_jump() << std::endl;
+		}
+
+		void compile(ast::grammar_rule& r) {
+			bool typed = ! r.type.empty();
+			bool has_error = ! r.error.empty();
+			bool memoized = do_memo && r.memo;
+			
+			//regular lexical rules run as automata
+			automaton a;
+			if ( dfas(r, a) ) {
+				out << "\tbool " << r.name << "(parser::state& ps) {" << std::endl;
+				a.print(out, "\t\t");
+				out << "\t}" << std::endl
+				    << std::endl;
+				return;
+			}
+			
+			unsigned long memo_id = memoized ? ++max_memo_id : 0;
+			
+			//generate rule body
+			body.str("");
+			used.clear();
+			n_posns = n_labels = 0;
+			fail = "psFail";
+			r.m->accept(this);
+
+			//print prototype
+			out << "\tbool " << r.name << "(parser::state& ps";
+			if ( typed ) out << ", " << r.type << "& psVal";
+			out << ") {" << std::endl;
+			
+			out << "\t\tparser::posn psStart = ps.posn();" << std::endl;
+			
+			//check memo table
+			if ( memoized ) {
+				out << "\t\tbool psMemo;" << std::endl
+				    << "\t\tif ( ps." << ( typed && r.once ? "memo_take(" : "memo(" ) 
+				    << memo_id << ", psMemo" 
+				    << (typed ? ", psVal" : "") << ") ) return psMemo;" << std::endl;
+			}
+			
+			//setup bound variables
+			std::map<std::string, std::string> vs = vars.list(r);
+			//skip parser variables
+			vs.erase("ps");
+			vs.erase("psVal");
+			for (auto it = vs.begin(); it != vs.end(); ++it) {
+				// add variable binding
+				out << "\t\t" << it->second << " " << it->first << ";" << std::endl;
+			}
+			
+			//setup backtracking positions
+			if ( n_posns > 0 ) {
+				out << "\t\tparser::posn psP1";
+				for (unsigned long i = 2; i <= n_posns; ++i) { out << ", psP" << i; }
+				out << ";" << std::endl;
+			}
+			out << std::endl;
+			
+			//apply matcher
+			out << body.str();
+			
+			//handle success
+			if ( memoized ) {
+				out << "\t\tps.set_memo(psStart, " << memo_id << ", true"
+				    << (typed ? ", psVal" : "") << ");" << std::endl;
+			}
+			out << "\t\treturn true;" << std::endl;
+			
+			//handle failure
+			if ( used.count("psFail") ) {
+				out << "\tpsFail:" << std::endl
+				    << "\t\tps.set_posn(psStart);" << std::endl;
+				if ( has_error ) {
+					out << "\t\t" << report("expect", r.error) << std::endl;
+				}
+				if ( memoized ) {
+					out << "\t\tps.set_memo(psStart, " << memo_id << ", false);" << std::endl;
+				}
+				out << "\t\treturn false;" << std::endl;
+			}
+
+			//close out method
+			out << "\t}" << std::endl
+				<< std::endl
+				;
+		}
+
+		/** Compiles a grammar to the output file. */
+		warning_list compile(ast::grammar& g) {
+			warnings = {};
+
+			//print pre-amble
+			if ( do_guard ) { out << "#pragma once\n" << std::endl; }
+			out << "/* THE FOLLOWING HAS BEEN AUTOMATICALLY GENERATED BY THE EGG PARSER GENERATOR." << std::endl
+				<< " * DO NOT EDIT. */" << std::endl
+				<< std::endl
+				;
+
+			//print pre-code
+			if ( ! g.pre.empty() ) {
+				out << "// {%" << std::endl
+					<< g.pre << std::endl
+					<< "// %}" << std::endl
+					<< std::endl
+					;
+			}
+
+			//get needed includes
+			out << "#include <string>" << std::endl
+				<< "#include \"parser.hpp\"" << std::endl
+				<< std::endl
+				;
+
+			//setup parser namespace
+			out << "namespace " << name << " {" << std::endl
+				<< std::endl
+				;
+
+			//pre-declare matchers
+			for (auto it = g.rs.begin(); it != g.rs.end(); ++it) {
+				ast::grammar_rule& r = **it;
+				out << "\tbool " << r.name << "(parser::state&";
+				if ( ! r.type.empty() ) {
+					out << ", " << r.type << "&";
+				}
+				out << ");" << std::endl;
+			}
+			out << std::endl;
+
+			//set up lists of variable types and FIRST sets
+			vars = variable_list(g);
+			firsts = first_sets(g);
+			scans = scan_loops(g, firsts);
+			dfas = automata(g, do_errors);
+			
+			//generate matching functions
+			for (auto it = g.rs.begin(); it != g.rs.end(); ++it) {
+				ast::grammar_rule& r = **it;
+				compile(r);
+			}
+
+			//close parser namespace
+			out << "} // namespace " << name << std::endl
+				<< std::endl
+				;
+			
+			//print post-code
+			if ( ! g.post.empty() ) {
+				out << "// {%" << std::endl
+					<< g.post << std::endl
+					<< "// %}" << std::endl
+					<< std::endl
+					;
+			}
+
+			return std::move(warnings);
+		}
+		
+	private:
+		std::string name;	        ///< Name of the grammar
+		std::ostream& out;	        ///< Output stream to print to
+		std::stringstream body;     ///< Buffer for the body of the current rule
+		variable_list vars;	        ///< Holds grammar rule types
+		first_sets firsts;          ///< Holds grammar FIRST sets
+		scan_loops scans;           ///< Finds repetitions which may be scanned
+		automata dfas;              ///< Compiles regular lexical rules to automata
+		warning_list warnings;      ///< Holds warnings
+		bool do_guard;              ///< Add include guard to generated file?
+		bool do_memo;               /**< if true, memoize if grammar says, otherwise no 
+		                             *   memoization [default true] */
+		bool do_errors;             /**< if true, report expected strings and error 
+		                             *   messages [default true] */
+		unsigned long max_memo_id;  ///< Largest currently used memoization ID
+		unsigned long n_posns;      ///< Number of backtracking positions in the current rule
+		unsigned long n_labels;     ///< Number of labels in the current rule
+		std::string fail;           ///< Label to jump to on failure of the current matcher
+		std::set<std::string> used; ///< Labels which have been jumped to in the current rule
+	}; /* class generator */
+	
+} /* namespace visitor */
@@ -0,0 +1,171 @@
+#pragma once
+
+/*
+ * Copyright (c) 2013 Aaron Moss
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <climits>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "../ast.hpp"
+#include "../utils/strings.hpp"
+
+namespace visitor {
+	
+	/** A trie of the character and string literal alternatives of a choice, printed as a 
+	 *  single pass over the input which matches whichever alternative the choice would. 
+	 *  Under ordered choice the first listed literal which matches wins, so the printed code 
+	 *  follows the input down the trie only while a literal listed before the best match 
+	 *  found so far may still match, then consumes that best match; as each literal tried 
+	 *  and missed before it would have recorded a failure, so does the trie. */
+	class literal_trie {
+	public:
+		/** @return may the given alternative be merged into a trie? */
+		static bool literal(const ast::matcher_ptr& m) {
+			return m->type() == ast::char_type || m->type() == ast::str_type;
+		}
+		
+		/** @return the end of the run of literal alternatives starting at it */
+		template <typename It>
+		static It run(It it, It end) {
+			while ( it != end && literal(*it) ) ++it;
+			return it;
+		}
+		
+		/** Builds the trie of a run of literal alternatives */
+		template <typename It>
+		literal_trie(It begin, It end) : nodes(1) {
+			for (; begin != end; ++begin) {
+				ast::matcher& m = **begin;
+				add(m.type() == ast::char_type 
+				    ? std::string(1, static_cast<ast::char_matcher&>(m).c) 
+				    : static_cast<ast::str_matcher&>(m).s);
+			}
+		}
+		
+		/** Prints the matching code as a sequence of statements.
+		 *  @param out		The stream to print to
+		 *  @param indent	The indentation of each line
+		 *  @param ok		The statement to continue with after a match
+		 *  @param no		The statement to continue with if no literal matches
+		 */
+		void print(std::ostream& out, const std::string& indent, 
+		           const std::string& ok, const std::string& no) const {
+			print(out, 0, 0, INT_MAX, indent, ok, no);
+		}
+		
+		/** Prints the matching code as a parser combinator lambda.
+		 *  @param out		The stream to print to
+		 *  @param indent	The indentation of the lambda's closing line
+		 */
+		void print_lambda(std::ostream& out, const std::string& indent) const {
+			out << "[](parser::state& ps) -> bool {" << std::endl;
+			print(out, indent + "\t", "return true;", "return false;");
+			out << indent << "}";
+		}
+		
+	private:
+		/** Trie node */
+		struct node {
+			node() : alt(INT_MAX), least(INT_MAX) {}
+			
+			std::map<char, unsigned> next;  ///< Child nodes by character
+			int alt;                        ///< First alternative ending here [INT_MAX for none]
+			int least;                      ///< First alternative ending in this subtree
+		};
+		
+		/** Adds the next alternative to the trie */
+		void add(const std::string& s) {
+			int a = lits.size();
+			lits.push_back(s);
+			
+			unsigned n = 0;
+			nodes[0].least = std::min(nodes[0].least, a);
+			for (char c : s) {
+				auto it = nodes[n].next.find(c);
+				if ( it == nodes[n].next.end() ) {
+					nodes.emplace_back();
+					it = nodes[n].next.emplace(c, nodes.size() - 1).first;
+				}
+				n = it->second;
+				nodes[n].least = std::min(nodes[n].least, a);
+			}
+			nodes[n].alt = std::min(nodes[n].alt, a);
+		}
+		
+		/** Prints the code to consume the best match found, or fail if none */
+		void print_end(std::ostream& out, int best, const std::string& indent, 
+		               const std::string& ok, const std::string& no) const {
+			out << indent;
+			// literals listed before the best match were tried, and failed
+			if ( best != 0 ) { out << "ps.fail(); "; }
+			if ( best == INT_MAX ) {
+				out << no << std::endl;
+				return;
+			}
+			
+			if ( ! lits[best].empty() ) { out << "ps += " << lits[best].size() << "; "; }
+			out << ok << std::endl;
+		}
+		
+		/** Prints the code to match from a node of the trie.
+		 *  @param n		The node
+		 *  @param depth	The depth of the node, the offset of its next character
+		 *  @param best		The best match found so far [INT_MAX for none]
+		 */
+		void print(std::ostream& out, unsigned n, unsigned depth, int best, 
+		           const std::string& indent, const std::string& ok, 
+		           const std::string& no) const {
+			best = std::min(best, nodes[n].alt);
+			
+			// only follow children which may hold a better match
+			bool any = false;
+			for (auto it = nodes[n].next.begin(); it != nodes[n].next.end(); ++it) {
+				if ( nodes[it->second].least < best ) { any = true; break; }
+			}
+			if ( ! any ) {
+				print_end(out, best, indent, ok, no);
+				return;
+			}
+			
+			out << indent << "switch ( ";
+			if ( depth == 0 ) { out << "ps()"; } else { out << "ps.peek(" << depth << ")"; }
+			out << " ) {" << std::endl;
+			for (auto it = nodes[n].next.begin(); it != nodes[n].next.end(); ++it) {
+				if ( nodes[it->second].least >= best ) continue;
+				
+				out << indent << "case \'" << strings::escape(it->first) << "\':" << std::endl;
+				print(out, it->second, depth + 1, best, indent + "\t", ok, no);
+			}
+			out << indent << "default:" << std::endl;
+			print_end(out, best, indent + "\t", ok, no);
+			out << indent << "}" << std::endl;
+		}
+		
+		std::vector<node> nodes;         ///< Trie nodes; the root is first
+		std::vector<std::string> lits;   ///< Literal alternatives, in order
+	}; /* class literal_trie */
+	
+} /* namespace visitor */
@@ -22,8 +22,10 @@
  * THE SOFTWARE.
  */
 
+#include <algorithm>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "../ast.hpp"
 #include "../utils/strings.hpp"
@@ -45,18 +47,30 @@ namespace visitor {
 		}
 
 		void visit(ast::range_matcher& m) {
-			out << "[";
-
-			for (auto iter = m.rs.begin(); iter != m.rs.end(); ++iter) {
-				ast::char_range& r = *iter;
-				out << strings::escape(r.from);
-				if ( r.from != r.to ) {
-					out << "-" << strings::escape(r.to);
+			// "[^]" would read back as the class of '^'
+			if ( m.neg && m.rs.empty() ) {
+				out << ".";
+			} else {
+				out << "[";
+				if ( m.neg ) { out << "^"; }
+				
+				// a leading '^' would read back as negation, so print it last
+				std::vector<ast::char_range> rs(m.rs);
+				if ( ! m.neg && rs.size() > 1 && rs.front().from == '^' ) {
+					std::rotate(rs.begin(), rs.begin() + 1, rs.end());
+				}
+				
+				for (auto iter = rs.begin(); iter != rs.end(); ++iter) {
+					ast::char_range& r = *iter;
+					out << strings::escape(r.from);
+					if ( r.from != r.to ) {
+						out << "-" << strings::escape(r.to);
+					}
 				}
+				
+				out << "]";
 			}
 			
-			out << "]";
-			
 			if ( ! m.var.empty() ) {
 				out << " : " << m.var;
 			}
@@ -158,6 +172,10 @@ namespace visitor {
 		void visit(ast::fail_matcher& m) {
 			out << "~`" << strings::unescape_error(m.error) << "`";
 		}
+		
+		void visit(ast::cut_matcher& m) {
+			out << "^";
+		}
 
 		void print(ast::grammar_rule& r) {
 			out << r.name;
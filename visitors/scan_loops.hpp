@@ -0,0 +1,265 @@
+#pragma once
+
+/*
+ * Copyright (c) 2013 Aaron Moss
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <bitset>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "../ast.hpp"
+#include "first_set.hpp"
+
+namespace visitor {
+	
+	/** A repetition which may skip a run of input by scanning for characters in a set, as 
+	 *  each of its iterations consumes exactly one character, and does so exactly when the 
+	 *  character is in the set. The last keep characters of the run are left to the 
+	 *  repetition itself, so that its final iterations report the same errors they would 
+	 *  have without the skip. */
+	struct scan_loop {
+		scan_loop() : keep(0) {}
+		
+		/** @return a C++ expression for a parser::scan_set of the characters */
+		std::string scan_set() const {
+			std::stringstream ss;
+			ss << "parser::scan_set{" << first_set::charset(chars) << ", {";
+			// split by high nibble into tables indexed by low nibble
+			for (unsigned t = 0; t < 2; ++t) {
+				if ( t > 0 ) ss << "}, {";
+				for (unsigned l = 0; l < 16; ++l) {
+					unsigned bits = 0;
+					for (unsigned h = 0; h < 8; ++h) {
+						if ( chars[16*(8*t + h) + l] ) bits |= 1u << h;
+					}
+					if ( l > 0 ) ss << ", ";
+					ss << "0x" << std::hex << std::setw(2) << std::setfill('0') << bits;
+				}
+			}
+			ss << "}}";
+			return ss.str();
+		}
+		
+		std::bitset<256> chars;  ///< Characters each iteration matches exactly one of
+		unsigned keep;           ///< Number of characters at the end of a run to leave
+	}; /* struct scan_loop */
+	
+	/** AST visitor with function-like interface that checks whether an expression consists 
+	 *  only of terminals, without variable bindings, rule invocations or lookahead. */
+	class is_terminal : ast::tree_visitor {
+	public:
+		/** Constructor; starts traversal */
+		is_terminal(const ast::matcher_ptr& m) : terminal(true) { m->accept(this); }
+		
+		operator bool () { return terminal; }
+		
+		void visit(ast::range_matcher& m) { terminal = terminal && m.var.empty(); }
+		void visit(ast::rule_matcher&)    { terminal = false; }
+		void visit(ast::any_matcher& m)   { terminal = terminal && m.var.empty(); }
+		void visit(ast::action_matcher&)  { terminal = false; }
+		void visit(ast::look_matcher&)    { terminal = false; }
+		void visit(ast::not_matcher&)     { terminal = false; }
+		void visit(ast::capt_matcher&)    { terminal = false; }
+		void visit(ast::fail_matcher&)    { terminal = false; }
+		void visit(ast::cut_matcher&)     { terminal = false; }
+	private:
+		bool terminal;  ///< Is the given expression only terminals?
+	}; /* class is_terminal */
+	
+	/** Finds the repetitions of an Egg grammar which may be run by scanning for a set of 
+	 *  characters: repetitions of a single-character matcher (a character, unbound character 
+	 *  class or `.`, a choice of them, or an untyped rule matching one), such as `[0-9]+` or 
+	 *  `( ' ' | '\t' )*`, and repetitions of a single-character matcher guarded by a negative 
+	 *  lookahead on another, such as `( !'}' . )*`. The lookahead may also be a choice with 
+	 *  further terminal alternatives, so long as they can only start with characters matched 
+	 *  by its single-character alternatives, as in `( !( "\r\n" | '\n' | '\r' ) . )*`. */
+	class scan_loops : ast::visitor {
+	public:
+		scan_loops() : ok(false) {}
+		
+		scan_loops(ast::grammar& g, const first_sets& firsts) : firsts(firsts), ok(false) {
+			for (auto it = g.rs.begin(); it != g.rs.end(); ++it) {
+				rules[(*it)->name] = *it;
+			}
+		}
+		
+		/** Checks if a repetition of the given matcher may be run by scanning.
+		 *  @param m		The repeated matcher
+		 *  @param s		Set to the scanned characters, if so
+		 *  @return may the repetition be scanned?
+		 */
+		bool operator() (const ast::matcher_ptr& m, scan_loop& s) {
+			std::bitset<256> cs;
+			if ( single(m, cs) ) {
+				s.chars = cs;
+				s.keep = 0;
+				return ! cs.none();
+			}
+			
+			// ( !x y ), where x matches exactly the characters of a set
+			if ( m->type() != ast::seq_type ) return false;
+			ast::seq_matcher& sm = static_cast<ast::seq_matcher&>(*m);
+			if ( sm.ms.size() != 2 || sm.ms[0]->type() != ast::not_type ) return false;
+			
+			std::bitset<256> xs;
+			if ( ! decides(static_cast<ast::not_matcher&>(*sm.ms[0]).m, xs) 
+			     || ! single(sm.ms[1], cs) ) return false;
+			
+			// leave the last iteration, which tests x on a character it fails on
+			s.chars = cs & ~xs;
+			s.keep = 1;
+			return ! s.chars.none();
+		}
+		
+		void visit(ast::char_matcher& m) {
+			rVal.set((unsigned char)m.c);
+		}
+		
+		void visit(ast::str_matcher& m) {
+			if ( m.s.size() != 1 ) { ok = false; return; }
+			rVal.set((unsigned char)m.s[0]);
+		}
+		
+		void visit(ast::range_matcher& m) {
+			if ( ! m.var.empty() ) { ok = false; return; }
+			rVal = chars(m);
+		}
+		
+		void visit(ast::rule_matcher& m) {
+			// only untyped rules run no actions when invoked unbound
+			auto it = rules.find(m.rule);
+			if ( ! m.var.empty() || it == rules.end() || ! it->second->type.empty() 
+			     || active.count(m.rule) ) { ok = false; return; }
+			
+			active.insert(m.rule);
+			it->second->m->accept(this);
+			active.erase(m.rule);
+		}
+		
+		void visit(ast::any_matcher& m) {
+			if ( ! m.var.empty() ) { ok = false; return; }
+			// '.' does not match the end of input, read as '\0'
+			rVal.set();
+			rVal.reset(0);
+		}
+		
+		void visit(ast::empty_matcher&) { ok = false; }
+		void visit(ast::action_matcher&) { ok = false; }
+		void visit(ast::opt_matcher&) { ok = false; }
+		void visit(ast::many_matcher&) { ok = false; }
+		void visit(ast::some_matcher&) { ok = false; }
+		
+		void visit(ast::seq_matcher& m) {
+			if ( m.ms.size() != 1 ) { ok = false; return; }
+			m.ms.front()->accept(this);
+		}
+		
+		void visit(ast::alt_matcher& m) {
+			if ( m.ms.empty() ) { ok = false; return; }
+			for (auto it = m.ms.begin(); ok && it != m.ms.end(); ++it) {
+				(*it)->accept(this);
+			}
+		}
+		
+		void visit(ast::look_matcher&) { ok = false; }
+		void visit(ast::not_matcher&) { ok = false; }
+		void visit(ast::capt_matcher&) { ok = false; }
+		
+		void visit(ast::named_matcher& m) {
+			m.m->accept(this);
+		}
+		
+		void visit(ast::fail_matcher&) { ok = false; }
+		void visit(ast::cut_matcher&) { ok = false; }
+		
+	private:
+		/** Checks if the given matcher consumes exactly one character, exactly when that 
+		 *  character is in a set, and has no other effects than reporting errors.
+		 *  @param m		The matcher to check
+		 *  @param cs		Set to the characters matched, if so
+		 */
+		bool single(const ast::matcher_ptr& m, std::bitset<256>& cs) {
+			ok = true;
+			rVal.reset();
+			m->accept(this);
+			cs = rVal;
+			return ok;
+		}
+		
+		/** Checks if the given matcher matches exactly when the current character is in a 
+		 *  set, and has no other effects than reporting errors.
+		 *  @param m		The matcher to check
+		 *  @param cs		Set to the characters it matches on, if so
+		 */
+		bool decides(const ast::matcher_ptr& m, std::bitset<256>& cs) {
+			if ( single(m, cs) ) return true;
+			
+			switch ( m->type() ) {
+			case ast::rule_type: {
+				ast::rule_matcher& rm = static_cast<ast::rule_matcher&>(*m);
+				auto it = rules.find(rm.rule);
+				if ( ! rm.var.empty() || it == rules.end() || ! it->second->type.empty() 
+				     || active.count(rm.rule) ) return false;
+				
+				active.insert(rm.rule);
+				bool d = decides(it->second->m, cs);
+				active.erase(rm.rule);
+				return d;
+			}
+			case ast::named_type:
+				return decides(static_cast<ast::named_matcher&>(*m).m, cs);
+			case ast::alt_type: {
+				// the single-character alternatives decide the match if the others may 
+				// only start with their characters
+				ast::alt_matcher& am = static_cast<ast::alt_matcher&>(*m);
+				std::bitset<256> ss, rest;
+				bool any = false;
+				for (auto it = am.ms.begin(); it != am.ms.end(); ++it) {
+					std::bitset<256> es;
+					if ( single(*it, es) ) { ss |= es; any = true; continue; }
+					
+					first_set f = firsts(*it);
+					if ( f.nullable || f.opaque || ! is_terminal(*it) ) return false;
+					rest |= f.chars;
+				}
+				if ( ! any || ( rest & ~ss ).any() ) return false;
+				cs = ss;
+				return true;
+			}
+			default:
+				return false;
+			}
+		}
+		
+		/** map of grammar rule names to rules */
+		std::unordered_map<std::string, ast::grammar_rule_ptr> rules;
+		std::unordered_set<std::string> active;  ///< Rules currently being expanded
+		first_sets firsts;                       ///< Holds grammar FIRST sets
+		std::bitset<256> rVal;                   ///< Characters matched by the current visit
+		bool ok;                                 ///< Does the current visit match one character?
+	}; /* class scan_loops */
+	
+} /* namespace visitor */